@@ -0,0 +1,76 @@
+#version 330 core
+// One step down the bloom chain: 13 bilinear taps (Jimenez, "Next Generation Post Processing in
+// Call of Duty: Advanced Warfare") into a target half the size of the source. The first step
+// also keeps only what exceeds the threshold and weights its taps by brightness, so a single
+// very bright pixel cannot flicker the whole bloom.
+
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D source;
+uniform vec2 texelSize; // of the source
+uniform vec2 uvScale;   // part of the source rendered this frame (dynamic resolution)
+uniform int prefilter;
+uniform float threshold;
+uniform float knee;
+
+float luminance(vec3 color)
+{
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Soft threshold: quadratic from threshold - knee, linear above threshold
+vec3 bright(vec3 color)
+{
+    float brightness = max(color.r, max(color.g, color.b));
+    float soft = clamp(brightness - threshold + knee, 0.0, 2.0 * knee);
+    soft = soft * soft / (4.0 * knee + 1e-5);
+    float contribution = max(soft, brightness - threshold) / max(brightness, 1e-5);
+    return color * contribution;
+}
+
+vec3 box(vec3 a, vec3 b, vec3 c, vec3 d)
+{
+    if (prefilter == 0) {
+        return (a + b + c + d) * 0.25;
+    }
+    // Karis average
+    a = bright(a); b = bright(b); c = bright(c); d = bright(d);
+    float wa = 1.0 / (1.0 + luminance(a));
+    float wb = 1.0 / (1.0 + luminance(b));
+    float wc = 1.0 / (1.0 + luminance(c));
+    float wd = 1.0 / (1.0 + luminance(d));
+    return (a * wa + b * wb + c * wc + d * wd) / (wa + wb + wc + wd);
+}
+
+// Offset in source texels, kept inside the rendered part
+vec3 tap(vec2 offset)
+{
+    vec2 uv = min(TexCoords * uvScale + offset * texelSize, uvScale - 0.5 * texelSize);
+    return texture(source, uv).rgb;
+}
+
+void main()
+{
+    vec3 a = tap(vec2(-2.0, -2.0));
+    vec3 b = tap(vec2( 0.0, -2.0));
+    vec3 c = tap(vec2( 2.0, -2.0));
+    vec3 d = tap(vec2(-1.0, -1.0));
+    vec3 e = tap(vec2( 1.0, -1.0));
+    vec3 f = tap(vec2(-2.0,  0.0));
+    vec3 g = tap(vec2( 0.0,  0.0));
+    vec3 h = tap(vec2( 2.0,  0.0));
+    vec3 i = tap(vec2(-1.0,  1.0));
+    vec3 j = tap(vec2( 1.0,  1.0));
+    vec3 k = tap(vec2(-2.0,  2.0));
+    vec3 l = tap(vec2( 0.0,  2.0));
+    vec3 m = tap(vec2( 2.0,  2.0));
+
+    // Five overlapping boxes, the center one weighted most
+    vec3 result = box(d, e, i, j) * 0.5;
+    result += box(a, b, f, g) * 0.125;
+    result += box(b, c, g, h) * 0.125;
+    result += box(f, g, k, l) * 0.125;
+    result += box(g, h, l, m) * 0.125;
+    FragColor = vec4(result, 1.0);
+}
@@ -0,0 +1,25 @@
+#version 330 core
+// One step up the bloom chain: a 3x3 tent filter over the smaller level, blended additively onto
+// the level above it
+
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D source;
+uniform vec2 texelSize; // of the source
+uniform vec2 uvScale;   // part of the source rendered this frame (dynamic resolution)
+
+// Offset in source texels, kept inside the rendered part
+vec3 tap(vec2 offset)
+{
+    vec2 uv = min(TexCoords * uvScale + offset * texelSize, uvScale - 0.5 * texelSize);
+    return texture(source, uv).rgb;
+}
+
+void main()
+{
+    vec3 result = tap(vec2(0.0)) * 4.0;
+    result += (tap(vec2(-1.0, 0.0)) + tap(vec2(1.0, 0.0)) + tap(vec2(0.0, -1.0)) + tap(vec2(0.0, 1.0))) * 2.0;
+    result += tap(vec2(-1.0, -1.0)) + tap(vec2(1.0, -1.0)) + tap(vec2(-1.0, 1.0)) + tap(vec2(1.0, 1.0));
+    FragColor = vec4(result / 16.0, 1.0);
+}
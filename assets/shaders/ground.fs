@@ -18,7 +18,10 @@ struct PointLight {
     float quadratic;
 };
 
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
+// std140, filled from the renderer's stream buffer once per frame
+layout(std140) uniform PointLightBlock {
+    PointLight pointLights[MAX_POINT_LIGHTS];
+};
 uniform int numPointLights;
 
 void main()
@@ -43,7 +46,6 @@ void main()
         result += attenuation * (ambient + diffuse);
     }
 
-    // Gamma correction
-    result = pow(result, vec3(1.0 / 2.2));
-    FragColor = vec4(clamp(result, 0.0, 1.0), 1.0);
+    // Linear and unclamped, the resolve tone maps and gamma corrects
+    FragColor = vec4(result, 1.0);
 }
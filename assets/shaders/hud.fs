@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 TexCoords;
+in vec4 Color;
+out vec4 FragColor;
+
+uniform sampler2D glyphAtlas;
+
+void main()
+{
+    float coverage = texture(glyphAtlas, TexCoords).r;
+    FragColor = vec4(Color.rgb, Color.a * coverage);
+}
@@ -0,0 +1,21 @@
+#version 330 core
+// One instance per glyph, the quad corners come from gl_VertexID (4-vertex triangle strip)
+layout (location = 0) in vec4 aRect;   // x, y, width, height in pixels, origin top-left
+layout (location = 1) in float aGlyph; // cell in the atlas
+layout (location = 2) in vec4 aColor;
+
+out vec2 TexCoords;
+out vec4 Color;
+
+uniform vec2 screenSize;
+uniform vec2 atlasGrid; // columns, rows
+
+void main() {
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    vec2 pixel = aRect.xy + corner * aRect.zw;
+    gl_Position = vec4(pixel.x / screenSize.x * 2.0 - 1.0, 1.0 - pixel.y / screenSize.y * 2.0, 0.0, 1.0);
+
+    vec2 cell = vec2(mod(aGlyph, atlasGrid.x), floor(aGlyph / atlasGrid.x));
+    TexCoords = (cell + corner) / atlasGrid;
+    Color = aColor;
+}
@@ -1,9 +1,19 @@
 #version 330 core
-#define MAX_POINT_LIGHTS 64
+// Compiled per variant (ShaderVariants.h), the defines are inserted after #version:
+//   BULB_EMISSIVE  flickering bulb glow, no lighting
+//   NORMAL_MAP     tangent-space normal map, otherwise the interpolated vertex normal
+//   LIGHT_COUNT    point lights summed, a multiple of 8; unused slots are uploaded black
+#ifndef LIGHT_COUNT
+#define LIGHT_COUNT 0
+#endif
 
 in vec2 TexCoords;
 in vec3 FragPos;
+#if !defined(BULB_EMISSIVE) && defined(NORMAL_MAP)
 in mat3 TBN;
+#elif !defined(BULB_EMISSIVE)
+in vec3 Normal;
+#endif
 
 out vec4 FragColor;
 
@@ -12,7 +22,6 @@ uniform vec3 viewPos;
 uniform sampler2D diffuseMap;
 uniform sampler2D normalMap;
 
-uniform int forceBulbColor; // 0 = normal material, 1 = emissive override
 uniform float time;
 
 struct PointLight {
@@ -25,33 +34,38 @@ struct PointLight {
     float quadratic;
 };
 
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform int numPointLights;
+#if LIGHT_COUNT > 0
+// std140, filled from the renderer's stream buffer once per frame
+layout(std140) uniform PointLightBlock {
+    PointLight pointLights[LIGHT_COUNT];
+};
+#endif
 
 void main()
 {
-    // Fallback: show bright red if nothing works
-    //vec3 texColor = vec3(1.0, 0.8, 0.3); // override textures
-    
+#ifdef BULB_EMISSIVE
+    float flicker = 0.85 + 0.15 * sin(time * 8.0 + FragPos.x * 5.0); // unique light flickering per bulb
+    // Well above 1.0, so the bloom picks the bulbs up
+    vec3 glow = vec3(1.0, 0.85, 0.4) * flicker * 4.0;
+    FragColor = vec4(glow, 1.0);
+#else
     vec3 result = vec3(0.0);
 
     vec3 texColor = texture(diffuseMap, TexCoords).rgb;
-    if (forceBulbColor == 1) {
-        float flicker = 0.85 + 0.15 * sin(time * 8.0 + FragPos.x * 5.0); // unique light flickering per bulb
-        vec3 glow = vec3(1.0, 0.85, 0.4) * flicker * 1.5;
-        glow = pow(glow, vec3(1.0 / 2.2));
-        FragColor = vec4(clamp(glow, 0.0, 1.0), 1.0);
-        return;
-    }
-
 
-
-    vec3 sampledNormal = texture(normalMap, TexCoords).rgb;
-    vec3 normal = normalize(TBN * (sampledNormal * 2.0 - 1.0));
+#ifdef NORMAL_MAP
+    // Only XY is stored (BC5 has two channels), Z is rebuilt from the unit length
+    vec2 normalXY = texture(normalMap, TexCoords).rg * 2.0 - 1.0;
+    vec3 sampledNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
+    vec3 normal = normalize(TBN * sampledNormal);
+#else
+    vec3 normal = normalize(Normal);
+#endif
 
     vec3 viewDir = normalize(viewPos - FragPos);
 
-    for (int i = 0; i < numPointLights; ++i) {
+#if LIGHT_COUNT > 0
+    for (int i = 0; i < LIGHT_COUNT; ++i) {
         vec3 lightDir = normalize(pointLights[i].position - FragPos);
         float diff = max(dot(normal, lightDir), 0.0);
         vec3 reflectDir = reflect(-lightDir, normal);
@@ -67,12 +81,10 @@ void main()
 
         result += attenuation * (ambient + diffuse + specular);
     }
+#endif
 
-    // Boost brightness slightly before gamma
+    // Boost brightness slightly, the resolve tone maps and gamma corrects
     result *= 1.8; // or 2.0 if still a bit dim
-
-    // Apply gamma correction
-    result = pow(result, vec3(1.0 / 2.2));
-    result = clamp(result, 0.0, 1.0);
     FragColor = vec4(result, 1.0);
+#endif
 }
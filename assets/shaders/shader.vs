@@ -1,4 +1,5 @@
 #version 330 core
+// Compiled per variant, see shader.fs for the defines
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
@@ -8,7 +9,11 @@ layout (location = 4) in vec3 aBitangent;
 
 out vec2 TexCoords;
 out vec3 FragPos;
+#if !defined(BULB_EMISSIVE) && defined(NORMAL_MAP)
 out mat3 TBN;
+#elif !defined(BULB_EMISSIVE)
+out vec3 Normal;
+#endif
 
 uniform mat4 model;
 uniform mat4 view;
@@ -16,10 +21,14 @@ uniform mat4 projection;
 
 void main()
 {
+#if !defined(BULB_EMISSIVE) && defined(NORMAL_MAP)
     vec3 T = normalize(mat3(model) * aTangent);
     vec3 B = normalize(mat3(model) * aBitangent);
     vec3 N = normalize(mat3(model) * aNormal);
     TBN = mat3(T, B, N);
+#elif !defined(BULB_EMISSIVE)
+    Normal = mat3(model) * aNormal;
+#endif
 
     vec4 worldPos = model * vec4(aPos, 1.0);
     FragPos = vec3(worldPos);
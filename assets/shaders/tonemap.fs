@@ -0,0 +1,34 @@
+#version 330 core
+// Resolves the linear HDR scene for display: upscales it bilinearly from the rendered part of the
+// target (dynamic resolution), adds the bloom, tone maps with the ACES filmic curve (Narkowicz
+// fit) and encodes sRGB. The only gamma step of the frame.
+
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D scene;
+uniform sampler2D bloom; // half resolution, upsampled by the bilinear tap
+uniform vec2 sceneUvScale, bloomUvScale; // rendered part of each
+uniform vec2 sceneTexelSize, bloomTexelSize;
+uniform float bloomStrength;
+uniform float exposure;
+
+vec3 acesFilmic(vec3 x)
+{
+    return clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+}
+
+vec3 linearToSrgb(vec3 color)
+{
+    vec3 low = color * 12.92;
+    vec3 high = 1.055 * pow(color, vec3(1.0 / 2.4)) - 0.055;
+    return mix(high, low, lessThanEqual(color, vec3(0.0031308)));
+}
+
+void main()
+{
+    vec2 sceneUv = min(TexCoords * sceneUvScale, sceneUvScale - 0.5 * sceneTexelSize);
+    vec2 bloomUv = min(TexCoords * bloomUvScale, bloomUvScale - 0.5 * bloomTexelSize);
+    vec3 hdr = texture(scene, sceneUv).rgb + texture(bloom, bloomUv).rgb * bloomStrength;
+    FragColor = vec4(linearToSrgb(acesFilmic(hdr * exposure)), 1.0);
+}
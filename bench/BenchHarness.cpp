@@ -0,0 +1,122 @@
+#include "BenchHarness.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+
+std::atomic<uint64_t> AllocationCounters::count{ 0 };
+std::atomic<uint64_t> AllocationCounters::bytes{ 0 };
+
+// ----- Allocation counting ----- //
+// Every other form of new (arrays, nothrow) ends up here. Over-aligned allocations are not
+// counted, nothing benchmarked uses them.
+void* operator new(std::size_t size) {
+    AllocationCounters::count.fetch_add(1, std::memory_order_relaxed);
+    AllocationCounters::bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+namespace {
+
+// Per-second rates with an SI prefix, "12.3 M"
+std::string formatRate(double perSecond) {
+    const char* prefixes[] = { "", "k", "M", "G", "T" };
+    int prefix = 0;
+    while (perSecond >= 1000.0 && prefix < 4) {
+        perSecond /= 1000.0;
+        ++prefix;
+    }
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.3g %s", perSecond, prefixes[prefix]);
+    return text;
+}
+
+// Names and inputs are plain ASCII, only quotes and backslashes need escaping
+std::string jsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+}
+
+BenchRunner::BenchRunner(double minSeconds, std::string filter)
+    : minSeconds(minSeconds), filter(std::move(filter)) {
+    std::printf("%-36s %-34s %14s %14s %14s %10s\n", "benchmark", "input", "ns/op", "items/s", "bytes/s", "allocs/op");
+}
+
+void BenchRunner::Run(const std::string& name, const std::string& input, size_t itemsPerOp, size_t bytesPerOp,
+    const std::function<void()>& body) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+
+    body(); // warm caches and lazily built state, not measured
+    uint64_t iterations = 1;
+    double seconds = 0.0;
+    uint64_t allocations = 0, allocatedBytes = 0;
+    for (;;) {
+        uint64_t countBefore = AllocationCounters::count.load(), bytesBefore = AllocationCounters::bytes.load();
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i) {
+            body();
+        }
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocations = AllocationCounters::count.load() - countBefore;
+        allocatedBytes = AllocationCounters::bytes.load() - bytesBefore;
+        if (seconds >= minSeconds || iterations >= (1ull << 40)) break;
+        // Aim straight for the minimum once a batch is long enough to extrapolate from
+        iterations = seconds > minSeconds / 100.0 ? static_cast<uint64_t>(iterations * minSeconds / seconds * 1.2) + 1 : iterations * 10;
+    }
+
+    BenchResult result;
+    result.name = name;
+    result.input = input;
+    result.iterations = iterations;
+    result.nsPerOp = seconds * 1.0e9 / iterations;
+    result.itemsPerSecond = itemsPerOp * iterations / seconds;
+    result.bytesPerSecond = bytesPerOp * iterations / seconds;
+    result.allocationsPerOp = static_cast<double>(allocations) / iterations;
+    result.allocatedBytesPerOp = static_cast<double>(allocatedBytes) / iterations;
+    results.push_back(result);
+
+    std::printf("%-36s %-34s %14.1f %14s %14s %10.2f\n", name.c_str(), input.c_str(), result.nsPerOp,
+        formatRate(result.itemsPerSecond).c_str(), bytesPerOp ? formatRate(result.bytesPerSecond).c_str() : "-",
+        result.allocationsPerOp);
+    std::fflush(stdout);
+}
+
+void BenchRunner::Skip(const std::string& name, const std::string& reason) {
+    if (!filter.empty() && name.find(filter) == std::string::npos) return;
+    std::printf("%-36s skipped: %s\n", name.c_str(), reason.c_str());
+}
+
+bool BenchRunner::WriteJson(const std::filesystem::path& path) const {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "[Bench] Could not write " << path.string() << std::endl;
+        return false;
+    }
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult& r = results[i];
+        out << "    { \"name\": " << jsonString(r.name) << ", \"input\": " << jsonString(r.input) << ", \"iterations\": " << r.iterations
+            << ", \"nsPerOp\": " << r.nsPerOp << ", \"itemsPerSecond\": " << r.itemsPerSecond << ", \"bytesPerSecond\": " << r.bytesPerSecond
+            << ", \"allocationsPerOp\": " << r.allocationsPerOp << ", \"allocatedBytesPerOp\": " << r.allocatedBytesPerOp << " }"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return true;
+}
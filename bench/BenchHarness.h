@@ -0,0 +1,64 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Heap allocations of the whole process, counted by the operator new replacement in BenchHarness.cpp
+struct AllocationCounters {
+    static std::atomic<uint64_t> count, bytes;
+};
+
+// Keeps the compiler from discarding a result that is otherwise unused: the empty asm claims to
+// read the value and clobber memory, so it has to be computed and stored
+template <typename T>
+void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+struct BenchResult {
+    std::string name;  // what is timed, e.g. "ModelLoader::ConvertMesh"
+    std::string input; // what it ran on, e.g. "synthetic 10k vertices" or a mesh of the real model
+    uint64_t iterations = 0;
+    double nsPerOp = 0.0;
+    double itemsPerSecond = 0.0;  // items as given to Run(), e.g. vertices or matrices
+    double bytesPerSecond = 0.0;  // 0 when the benchmark has no meaningful byte count
+    double allocationsPerOp = 0.0, allocatedBytesPerOp = 0.0;
+};
+
+// Runs each body in batches of doubling size until one batch takes at least minSeconds, then
+// reports that batch: time per call, throughput and the heap allocations made during it.
+// Bodies should do enough work per call (e.g. a whole array of matrices) that the std::function
+// call does not dominate.
+class BenchRunner {
+public:
+    BenchRunner(double minSeconds, std::string filter);
+
+    // itemsPerOp and bytesPerOp are the work one call of body does
+    void Run(const std::string& name, const std::string& input, size_t itemsPerOp, size_t bytesPerOp,
+        const std::function<void()>& body);
+    // Printed in place of a result, e.g. when the real asset could not be loaded
+    void Skip(const std::string& name, const std::string& reason);
+
+    const std::vector<BenchResult>& GetResults() const { return results; }
+    // {"benchmarks": [{"name", "input", "iterations", "nsPerOp", ...}, ...]}
+    bool WriteJson(const std::filesystem::path& path) const;
+
+private:
+    double minSeconds;
+    std::string filter; // only names containing it run, empty for all
+    std::vector<BenchResult> results;
+};
+
+#endif
@@ -0,0 +1,374 @@
+// stb initializes its write context with { 0 }, which -Wextra flags
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "AssetManager.h"
+#include "BenchHarness.h"
+#include "JobSystem.h"
+#include "ModelLoader.h"
+#include "SceneGraph.h"
+#include "Simulation.h"
+
+// carousel_bench [--filter <name part>] [--min-time <seconds>] [--out <file>] [--assets <dir>]
+// Microbenchmarks of the loader and math hot paths, each on the real carousel (when assimp can
+// read it) and on synthetic inputs of increasing size. Prints a table and writes the results as
+// JSON (carousel_bench.json by default) for tracking over time.
+
+namespace {
+
+// ----- Synthetic inputs ----- //
+
+// An aiMesh over storage owned here. The pointers are cleared before the aiMesh is destroyed,
+// assimp's destructors would otherwise free them.
+class SyntheticMesh {
+public:
+    SyntheticMesh() = default;
+    ~SyntheticMesh() {
+        for (aiFace& face : faces) face.mIndices = nullptr;
+        mesh.mVertices = mesh.mNormals = mesh.mTangents = mesh.mBitangents = nullptr;
+        mesh.mTextureCoords[0] = nullptr;
+        mesh.mFaces = nullptr;
+        mesh.mNumVertices = mesh.mNumFaces = 0;
+    }
+    SyntheticMesh(const SyntheticMesh&) = delete;
+    SyntheticMesh& operator=(const SyntheticMesh&) = delete;
+
+    // A side x side vertex grid with a bump, two triangles per cell, full tangent frames
+    void BuildGrid(int side) {
+        for (int z = 0; z < side; ++z) {
+            for (int x = 0; x < side; ++x) {
+                float u = static_cast<float>(x) / (side - 1), v = static_cast<float>(z) / (side - 1);
+                positions.push_back(vector(u * 10.0f, std::sin(u * 6.0f) * std::cos(v * 6.0f), v * 10.0f));
+                normals.push_back(vector(0.0f, 1.0f, 0.0f));
+                tangents.push_back(vector(1.0f, 0.0f, 0.0f));
+                bitangents.push_back(vector(0.0f, 0.0f, 1.0f));
+                uvs.push_back(vector(u, v, 0.0f));
+            }
+        }
+        for (int z = 0; z + 1 < side; ++z) {
+            for (int x = 0; x + 1 < side; ++x) {
+                unsigned int i = static_cast<unsigned int>(z * side + x), below = i + side;
+                unsigned int quad[6] = { i, below, i + 1, i + 1, below, below + 1 };
+                indices.insert(indices.end(), quad, quad + 6);
+            }
+        }
+        finish();
+    }
+
+    // clusterCount small spheres of verticesPerBulb vertices, 0.5 apart, like the bulb meshes
+    void BuildBulbs(int clusterCount, int verticesPerBulb) {
+        for (int c = 0; c < clusterCount; ++c) {
+            float angle = c * 6.2831853f / clusterCount, radius = 0.5f * clusterCount / 6.2831853f + 1.0f;
+            for (int v = 0; v < verticesPerBulb; ++v) {
+                float a = v * 2.3999632f, h = 1.0f - 2.0f * (v + 0.5f) / verticesPerBulb, r = std::sqrt(1.0f - h * h);
+                positions.push_back(vector(radius * std::cos(angle) + 0.02f * r * std::cos(a), 2.0f + 0.02f * h,
+                    radius * std::sin(angle) + 0.02f * r * std::sin(a)));
+                normals.push_back(vector(r * std::cos(a), h, r * std::sin(a)));
+            }
+        }
+        finish();
+    }
+
+    const aiMesh* Get() const { return &mesh; }
+    unsigned int GetVertexCount() const { return mesh.mNumVertices; }
+
+private:
+    static aiVector3D vector(float x, float y, float z) {
+        aiVector3D v;
+        v.x = x;
+        v.y = y;
+        v.z = z;
+        return v;
+    }
+
+    void finish() {
+        faces.resize(indices.size() / 3);
+        for (size_t i = 0; i < faces.size(); ++i) {
+            faces[i].mNumIndices = 3;
+            faces[i].mIndices = &indices[i * 3];
+        }
+        mesh.mNumVertices = static_cast<unsigned int>(positions.size());
+        mesh.mVertices = positions.data();
+        mesh.mNormals = normals.data();
+        mesh.mTangents = tangents.empty() ? nullptr : tangents.data();
+        mesh.mBitangents = bitangents.empty() ? nullptr : bitangents.data();
+        mesh.mTextureCoords[0] = uvs.empty() ? nullptr : uvs.data();
+        mesh.mNumFaces = static_cast<unsigned int>(faces.size());
+        mesh.mFaces = faces.empty() ? nullptr : faces.data();
+    }
+
+    std::vector<aiVector3D> positions, normals, tangents, bitangents, uvs;
+    std::vector<unsigned int> indices;
+    std::vector<aiFace> faces;
+    aiMesh mesh;
+};
+
+// A gradient with noise, so the JPEG is neither trivial nor incompressible
+std::vector<unsigned char> encodeSyntheticJpeg(int size) {
+    std::vector<unsigned char> pixels(static_cast<size_t>(size) * size * 3);
+    uint32_t noise = 12345;
+    for (size_t i = 0; i < pixels.size(); ++i) {
+        noise = noise * 1664525u + 1013904223u;
+        size_t pixel = i / 3;
+        int x = static_cast<int>(pixel % size), y = static_cast<int>(pixel / size);
+        pixels[i] = static_cast<unsigned char>(((x + y) * 255 / (2 * size) + (noise >> 28)) & 0xff);
+    }
+    std::vector<unsigned char> jpeg;
+    stbi_write_jpg_to_func([](void* context, void* data, int bytes) {
+        auto* out = static_cast<std::vector<unsigned char>*>(context);
+        out->insert(out->end(), static_cast<unsigned char*>(data), static_cast<unsigned char*>(data) + bytes);
+        }, &jpeg, size, size, 3, pixels.data(), 90);
+    return jpeg;
+}
+
+// parent of node i is (i - 1) / fanOut, so ids stay parents first
+std::unique_ptr<SceneGraph> buildTree(size_t nodeCount, size_t fanOut) {
+    auto graph = std::make_unique<SceneGraph>();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        SceneGraph::NodeId parent = i == 0 ? SceneGraph::NoNode : static_cast<SceneGraph::NodeId>((i - 1) / fanOut);
+        graph->AddNode("node", parent, glm::translate(glm::mat4(1.0f), glm::vec3(0.1f, 0.0f, 0.0f)));
+    }
+    return graph;
+}
+
+// A flat model: every mesh on its own node under one root, plus bulbs
+void syntheticModel(size_t meshCount, std::vector<SceneNodeData>& nodes, std::vector<glm::vec3>& bulbs, size_t bulbCount) {
+    nodes.resize(meshCount + 1);
+    nodes[0].name = "root";
+    for (size_t i = 0; i < meshCount; ++i) {
+        nodes[i + 1].name = "mesh";
+        nodes[i + 1].parent = 0;
+        nodes[i + 1].local = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i % 16), 0.0f, static_cast<float>(i / 16)));
+        nodes[i + 1].meshes = { static_cast<unsigned int>(i) };
+    }
+    for (size_t i = 0; i < bulbCount; ++i) {
+        float angle = i * 6.2831853f / bulbCount;
+        bulbs.push_back(glm::vec3(300.0f * std::cos(angle), 250.0f, 300.0f * std::sin(angle)));
+    }
+}
+
+std::string countLabel(size_t count, const char* unit) {
+    std::string number = count >= 1000000 && count % 1000000 == 0 ? std::to_string(count / 1000000) + "M"
+        : count >= 1000 && count % 1000 == 0 ? std::to_string(count / 1000) + "k" : std::to_string(count);
+    return number + " " + unit;
+}
+
+bool isBulbMesh(const std::string& name) {
+    std::string lower = name;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower.find("bulb") != std::string::npos || lower.find("light") != std::string::npos || lower.find("lit") != std::string::npos;
+}
+
+// ----- Benchmarks ----- //
+
+void benchConvertMesh(BenchRunner& bench, const aiScene* scene) {
+    const char* name = "ModelLoader::ConvertMesh";
+    if (scene && scene->mNumMeshes > 0) {
+        size_t vertices = 0;
+        for (unsigned int i = 0; i < scene->mNumMeshes; ++i) vertices += scene->mMeshes[i]->mNumVertices;
+        bench.Run(name, "carousel, " + std::to_string(scene->mNumMeshes) + " meshes", vertices, vertices * sizeof(Vertex), [scene] {
+            for (unsigned int i = 0; i < scene->mNumMeshes; ++i) {
+                std::vector<Vertex> vertices;
+                std::vector<unsigned int> indices;
+                ModelLoader::ConvertMesh(scene->mMeshes[i], vertices, indices);
+                DoNotOptimize(vertices.data());
+            }
+            });
+    }
+    else bench.Skip(name + std::string(" (carousel)"), "model not loaded");
+
+    for (int side : { 32, 100, 317, 1000 }) {
+        SyntheticMesh mesh;
+        mesh.BuildGrid(side);
+        bench.Run(name, "grid " + countLabel(mesh.GetVertexCount(), "vertices"), mesh.GetVertexCount(),
+            mesh.GetVertexCount() * sizeof(Vertex), [&mesh] {
+                std::vector<Vertex> vertices;
+                std::vector<unsigned int> indices;
+                ModelLoader::ConvertMesh(mesh.Get(), vertices, indices);
+                DoNotOptimize(vertices.data());
+            });
+    }
+}
+
+void benchClusterBulbs(BenchRunner& bench, const aiScene* scene) {
+    const char* name = "ModelLoader::ClusterBulbs";
+    std::vector<const aiMesh*> bulbMeshes;
+    size_t vertices = 0;
+    for (unsigned int i = 0; scene && i < scene->mNumMeshes; ++i) {
+        if (isBulbMesh(scene->mMeshes[i]->mName.C_Str())) {
+            bulbMeshes.push_back(scene->mMeshes[i]);
+            vertices += scene->mMeshes[i]->mNumVertices;
+        }
+    }
+    if (!bulbMeshes.empty()) {
+        bench.Run(name, "carousel, " + std::to_string(bulbMeshes.size()) + " bulb meshes", vertices, 0, [&bulbMeshes] {
+            for (const aiMesh* mesh : bulbMeshes) {
+                DoNotOptimize(ModelLoader::ClusterBulbs(mesh));
+            }
+            });
+    }
+    else bench.Skip(name + std::string(" (carousel)"), "model not loaded or has no bulb meshes");
+
+    for (auto [clusters, perBulb] : { std::pair<int, int>{ 8, 24 }, { 64, 24 }, { 64, 384 } }) {
+        SyntheticMesh mesh;
+        mesh.BuildBulbs(clusters, perBulb);
+        bench.Run(name, std::to_string(clusters) + " bulbs x " + std::to_string(perBulb) + " vertices", mesh.GetVertexCount(), 0,
+            [&mesh] { DoNotOptimize(ModelLoader::ClusterBulbs(mesh.Get())); });
+    }
+}
+
+void benchTextureDecode(BenchRunner& bench, const std::filesystem::path& textureDirectory) {
+    const char* name = "Texture decode + mips";
+    std::vector<std::filesystem::path> files;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(textureDirectory, error)) {
+        std::string extension = entry.path().extension().string();
+        if (extension == ".jpg" || extension == ".jpeg" || extension == ".png") files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) bench.Skip(name + std::string(" (carousel)"), "no textures in " + textureDirectory.string());
+    for (const std::filesystem::path& file : files) {
+        std::shared_ptr<const ImageData> image = AssetManager::ReadTexture(file, false);
+        if (!image->Valid()) continue;
+        bench.Run(name, file.filename().string(), static_cast<size_t>(image->width) * image->height,
+            static_cast<size_t>(std::filesystem::file_size(file, error)), [&file] {
+                DoNotOptimize(AssetManager::ReadTexture(file, false));
+            });
+    }
+
+    for (int size : { 256, 1024, 2048 }) {
+        std::vector<unsigned char> jpeg = encodeSyntheticJpeg(size);
+        bench.Run(name, "synthetic " + std::to_string(size) + "x" + std::to_string(size) + " JPEG",
+            static_cast<size_t>(size) * size, jpeg.size(), [&jpeg] {
+                auto image = std::make_shared<ImageData>();
+                unsigned char* pixels = stbi_load_from_memory(jpeg.data(), static_cast<int>(jpeg.size()), &image->width, &image->height, &image->channels, 0);
+                image->pixels.assign(pixels, pixels + static_cast<size_t>(image->width) * image->height * image->channels);
+                stbi_image_free(pixels);
+                AssetManager::GenerateMips(*image);
+                DoNotOptimize(image);
+            });
+    }
+}
+
+// A spinning carousel dirties every node each tick: scene graph update, light transforms, snapshot
+void benchSimulationTick(BenchRunner& bench, JobSystem& jobs, const ModelData* model) {
+    const char* name = "Simulation::Tick (spinning)";
+    InputFrame spin;
+    spin.down.set(GLFW_KEY_RIGHT);
+    auto run = [&](const std::string& input, const std::vector<SceneNodeData>& nodes, size_t meshCount, const std::vector<glm::vec3>& bulbs) {
+        auto simulation = std::make_shared<Simulation>(jobs);
+        simulation->SetModel(nodes, meshCount, bulbs);
+        auto frame = std::make_shared<FrameSnapshot>();
+        bench.Run(name, input, 1, 0, [simulation, frame, spin] { simulation->Tick(spin, *frame); });
+    };
+
+    if (model && !model->meshes.empty()) {
+        run("carousel, " + std::to_string(model->bulbPositions.size()) + " bulbs", model->nodes, model->meshes.size(), model->bulbPositions);
+    }
+    else bench.Skip(name + std::string(" (carousel)"), "model not loaded");
+
+    for (size_t meshes : { 16, 256, 4096 }) {
+        std::vector<SceneNodeData> nodes;
+        std::vector<glm::vec3> bulbs;
+        syntheticModel(meshes, nodes, bulbs, MaxPointLights);
+        run(countLabel(meshes, "meshes") + ", " + std::to_string(MaxPointLights) + " bulbs", nodes, meshes, bulbs);
+    }
+}
+
+void benchSceneGraph(BenchRunner& bench, JobSystem& jobs) {
+    const char* name = "SceneGraph::Update (all dirty)";
+    for (size_t nodes : { 1000, 16000, 128000 }) {
+        std::shared_ptr<SceneGraph> graph = buildTree(nodes, 4);
+        float angle = 0.0f;
+        bench.Run(name, countLabel(nodes, "nodes") + ", fan-out 4", nodes, nodes * sizeof(glm::mat4), [graph, &jobs, angle]() mutable {
+            angle += 0.01f;
+            graph->SetLocal(0, glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 1.0f, 0.0f)));
+            DoNotOptimize(graph->Update(jobs));
+            });
+    }
+}
+
+void benchMatrixMath(BenchRunner& bench) {
+    constexpr size_t Count = 4096;
+    auto a = std::make_shared<std::vector<glm::mat4>>(Count), b = std::make_shared<std::vector<glm::mat4>>(Count);
+    auto out = std::make_shared<std::vector<glm::mat4>>(Count);
+    auto points = std::make_shared<std::vector<glm::vec4>>(Count), transformed = std::make_shared<std::vector<glm::vec4>>(Count);
+    for (size_t i = 0; i < Count; ++i) {
+        float f = static_cast<float>(i);
+        (*a)[i] = glm::rotate(glm::translate(glm::mat4(1.0f), glm::vec3(f, 0.0f, -f)), f * 0.01f, glm::vec3(0.0f, 1.0f, 0.0f));
+        (*b)[i] = glm::scale(glm::mat4(1.0f), glm::vec3(1.0f + f * 0.001f));
+        (*points)[i] = glm::vec4(f, f * 0.5f, -f, 1.0f);
+    }
+
+    bench.Run("glm mat4 * mat4", countLabel(Count, "matrices"), Count, Count * sizeof(glm::mat4) * 3, [a, b, out] {
+        for (size_t i = 0; i < Count; ++i) (*out)[i] = (*a)[i] * (*b)[i];
+        DoNotOptimize(out->data());
+        });
+    bench.Run("glm mat4 * vec4", countLabel(Count, "points, one matrix"), Count, Count * sizeof(glm::vec4) * 2, [a, points, transformed] {
+        const glm::mat4 spin = (*a)[1];
+        for (size_t i = 0; i < Count; ++i) (*transformed)[i] = spin * (*points)[i];
+        DoNotOptimize(transformed->data());
+        });
+    bench.Run("glm inverse(mat4)", countLabel(Count, "matrices"), Count, Count * sizeof(glm::mat4) * 2, [a, out] {
+        for (size_t i = 0; i < Count; ++i) (*out)[i] = glm::inverse((*a)[i]);
+        DoNotOptimize(out->data());
+        });
+}
+
+}
+
+int main(int argc, char** argv) {
+    std::string filter;
+    double minSeconds = 0.25;
+    std::filesystem::path reportPath = "carousel_bench.json", assetRoot;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0) filter = argv[++i];
+        else if (std::strcmp(argv[i], "--min-time") == 0) minSeconds = std::max(0.001, std::atof(argv[++i]));
+        else if (std::strcmp(argv[i], "--out") == 0) reportPath = argv[++i];
+        else if (std::strcmp(argv[i], "--assets") == 0) assetRoot = argv[++i];
+    }
+    if (assetRoot.empty()) {
+        std::filesystem::path base = std::filesystem::current_path();
+        assetRoot = std::filesystem::exists(base.parent_path() / "assets") ? base.parent_path() / "assets" : base / "assets";
+    }
+
+    JobSystem jobs;
+    // The real model, read once; an import that fails leaves only the synthetic inputs
+    std::filesystem::path modelPath = assetRoot / "models" / "carousel.gltf";
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(modelPath.string(),
+        aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+    if (scene && (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE)) scene = nullptr;
+    std::shared_ptr<const ModelData> model = scene ? ModelLoader::Import(modelPath.string(), jobs, false) : nullptr;
+    std::cout << "[Bench] " << jobs.WorkerCount() << " job workers, model " << (scene ? modelPath.string() : "not loaded")
+        << ", at least " << minSeconds << " s per benchmark" << std::endl;
+
+    BenchRunner bench(minSeconds, filter);
+    benchConvertMesh(bench, scene);
+    benchClusterBulbs(bench, scene);
+    benchTextureDecode(bench, assetRoot / "textures");
+    benchSimulationTick(bench, jobs, model.get());
+    benchSceneGraph(bench, jobs);
+    benchMatrixMath(bench);
+
+    if (!bench.WriteJson(reportPath)) return 1;
+    std::cout << "[Bench] " << bench.GetResults().size() << " results written to " << reportPath.string() << std::endl;
+    return 0;
+}
@@ -0,0 +1,30 @@
+# Writes a C++ header with every input file as a constexpr byte array plus a lookup table, see
+# src/EmbeddedAssets.h. Runs at build time:
+#   cmake -DROOT=<assets dir> -DFILES=<a|b|...> -DOUTPUT=<header> -P EmbedAssets.cmake
+# FILES are relative to ROOT and separated by '|' (a ';' list does not survive the command line).
+
+string(REPLACE "|" ";" files "${FILES}")
+
+# CMake regexes have no {n} repetition, spell out 16 bytes per line
+string(REPEAT "0x..," 16 line)
+
+set(arrays "")
+set(table "")
+set(index 0)
+foreach(relative IN LISTS files)
+    file(READ "${ROOT}/${relative}" hex HEX)
+    string(LENGTH "${hex}" hexLength)
+    math(EXPR size "${hexLength} / 2")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${hex}")
+    string(REGEX REPLACE "(${line})" "\\1\n    " bytes "${bytes}")
+    # Always one trailing zero, so empty files still form an array and text is terminated
+    string(APPEND arrays "// ${relative}\nconstexpr unsigned char asset${index}[] = {\n    ${bytes}0x00\n};\n\n")
+    string(APPEND table "    { \"${relative}\", asset${index}, ${size} },\n")
+    math(EXPR index "${index} + 1")
+endforeach()
+
+set(content "// Generated by cmake/EmbedAssets.cmake from assets/, do not edit.\n")
+string(APPEND content "// Only included by src/EmbeddedAssets.cpp.\n\n")
+string(APPEND content "namespace {\n\n${arrays}constexpr EmbeddedFile EmbeddedFiles[] = {\n${table}};\n\n}\n")
+
+file(WRITE "${OUTPUT}" "${content}")
@@ -0,0 +1,174 @@
+#include "AssetManager.h"
+#include <fstream>
+#include <iostream>
+#include "stb_image.h"
+#include "CompressedTexture.h"
+#include "EmbeddedAssets.h"
+#include "Profiler.h"
+
+std::filesystem::path AssetManager::assetRoot, AssetManager::overrideRoot;
+
+void AssetManager::SetAssetDirectories(const std::filesystem::path& root, const std::filesystem::path& overrideDirectory) {
+    assetRoot = root;
+    overrideRoot = overrideDirectory;
+    std::cout << "[Assets] " << EmbeddedFileCount() << " files embedded";
+    if (!overrideRoot.empty()) std::cout << ", overridden by " << overrideRoot.string();
+    std::cout << std::endl;
+}
+
+const EmbeddedFile* AssetManager::resolve(const std::filesystem::path& path, std::filesystem::path& diskPath) {
+    diskPath = path;
+    if (assetRoot.empty()) return nullptr;
+    std::filesystem::path relative = path.lexically_relative(assetRoot);
+    if (relative.empty() || *relative.begin() == "..") return nullptr;
+
+    if (!overrideRoot.empty() && std::filesystem::exists(overrideRoot / relative)) {
+        diskPath = overrideRoot / relative;
+        return nullptr;
+    }
+    return FindEmbeddedFile(relative.generic_string());
+}
+
+AssetManager::AssetManager(unsigned int loaderThreads) {
+    if (loaderThreads == 0) loaderThreads = 1;
+    for (unsigned int i = 0; i < loaderThreads; ++i) {
+        loaders.emplace_back(&AssetManager::loaderLoop, this);
+    }
+}
+
+AssetManager::~AssetManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto& loader : loaders) {
+        loader.join();
+    }
+    // Whoever still waits on a dropped load gets an empty result rather than a broken promise
+    while (!requests.empty()) {
+        Request request = requests.top();
+        requests.pop();
+        request.cancel();
+        --pending;
+    }
+}
+
+void AssetManager::enqueue(AssetPriority priority, std::function<void()> work, std::function<void()> cancel) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requests.push(Request{ priority, nextSequence++, std::move(work), std::move(cancel) });
+        ++pending;
+    }
+    available.notify_one();
+}
+
+void AssetManager::loaderLoop() {
+    Profiler::SetThreadName("Asset loader");
+    while (true) {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !requests.empty(); });
+            if (stopping) return;
+            request = requests.top();
+            requests.pop();
+        }
+        request.work();
+        --pending;
+    }
+}
+
+AssetFuture<ImageData> AssetManager::LoadImage(const std::filesystem::path& path, AssetPriority priority, int desiredChannels, bool generateMips) {
+    return Submit<ImageData>(priority, [path, desiredChannels, generateMips] { return DecodeImage(path, desiredChannels, generateMips); });
+}
+
+AssetFuture<std::string> AssetManager::LoadText(const std::filesystem::path& path, AssetPriority priority) {
+    return Submit<std::string>(priority, [path] { return ReadText(path); });
+}
+
+AssetFuture<ImageData> AssetManager::LoadTexture(const std::filesystem::path& path, AssetPriority priority, bool allowBaked) {
+    return Submit<ImageData>(priority, [path, allowBaked] { return ReadTexture(path, allowBaked); });
+}
+
+std::shared_ptr<const ImageData> AssetManager::ReadTexture(const std::filesystem::path& path, bool allowBaked) {
+    PROFILE_SCOPE("ReadTexture");
+    std::filesystem::path baked = BakedTexturePath(path);
+    if (allowBaked && std::filesystem::exists(baked)) {
+        std::shared_ptr<const ImageData> image = ReadCompressedTexture(baked);
+        if (image->Valid()) {
+            return image;
+        }
+    }
+    return DecodeImage(path, 0, true);
+}
+
+std::shared_ptr<const ImageData> AssetManager::DecodeImage(const std::filesystem::path& path, int desiredChannels, bool generateMips) {
+    PROFILE_SCOPE("DecodeImage");
+    auto image = std::make_shared<ImageData>();
+    int width, height, nrComponents;
+    std::filesystem::path diskPath;
+    const EmbeddedFile* embedded = resolve(path, diskPath);
+    unsigned char* data = embedded
+        ? stbi_load_from_memory(embedded->data, static_cast<int>(embedded->size), &width, &height, &nrComponents, desiredChannels)
+        : stbi_load(diskPath.string().c_str(), &width, &height, &nrComponents, desiredChannels);
+    if (!data) {
+        std::cerr << "Failed to load image at path: " << diskPath.string() << std::endl;
+        return image;
+    }
+
+    image->width = width;
+    image->height = height;
+    image->channels = desiredChannels ? desiredChannels : nrComponents;
+    image->pixels.assign(data, data + static_cast<size_t>(width) * height * image->channels);
+    stbi_image_free(data);
+
+    if (generateMips) {
+        GenerateMips(*image);
+    }
+    return image;
+}
+
+void AssetManager::GenerateMips(ImageData& image) {
+    PROFILE_SCOPE("GenerateMips");
+    image.mips.clear();
+    int channels = image.channels;
+    int level = 0;
+
+    while (image.LevelWidth(level) > 1 || image.LevelHeight(level) > 1) {
+        int srcWidth = image.LevelWidth(level), srcHeight = image.LevelHeight(level);
+        int dstWidth = image.LevelWidth(level + 1), dstHeight = image.LevelHeight(level + 1);
+        const unsigned char* src = image.LevelPixels(level);
+        std::vector<unsigned char> dst(static_cast<size_t>(dstWidth) * dstHeight * channels);
+
+        for (int y = 0; y < dstHeight; ++y) {
+            int y0 = std::min(y * 2, srcHeight - 1), y1 = std::min(y * 2 + 1, srcHeight - 1);
+            for (int x = 0; x < dstWidth; ++x) {
+                int x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+                for (int c = 0; c < channels; ++c) {
+                    int sum = src[(static_cast<size_t>(y0) * srcWidth + x0) * channels + c] +
+                              src[(static_cast<size_t>(y0) * srcWidth + x1) * channels + c] +
+                              src[(static_cast<size_t>(y1) * srcWidth + x0) * channels + c] +
+                              src[(static_cast<size_t>(y1) * srcWidth + x1) * channels + c];
+                    dst[(static_cast<size_t>(y) * dstWidth + x) * channels + c] = static_cast<unsigned char>((sum + 2) / 4);
+                }
+            }
+        }
+
+        image.mips.push_back(std::move(dst));
+        ++level;
+    }
+}
+
+std::shared_ptr<const std::string> AssetManager::ReadText(const std::filesystem::path& path) {
+    PROFILE_SCOPE("ReadText");
+    std::filesystem::path diskPath;
+    if (const EmbeddedFile* embedded = resolve(path, diskPath)) {
+        return std::make_shared<const std::string>(reinterpret_cast<const char*>(embedded->data), embedded->size);
+    }
+    std::ifstream file(diskPath);
+    if (!file) {
+        std::cerr << "Failed to open file: " << diskPath.string() << std::endl;
+    }
+    return std::make_shared<const std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
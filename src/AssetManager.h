@@ -0,0 +1,135 @@
+#ifndef ASSET_MANAGER_H
+#define ASSET_MANAGER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct EmbeddedFile;
+
+// Higher priorities are picked first by the loader threads
+enum class AssetPriority {
+    Low = 0,
+    Normal = 1,   // carousel model and its textures
+    High = 2,     // ground and skybox, visible on the first frames
+    Critical = 3, // shader sources
+};
+
+// Decoded pixels, ready to be uploaded by the GL thread. The mip chain is optional and built
+// on the CPU so the GL thread never has to run glGenerateMipmap. Baked textures (.ctex) keep
+// their 4x4 blocks in the same level vectors and set compressedFormat instead of channels.
+struct ImageData {
+    int width = 0, height = 0, channels = 0;
+    unsigned int compressedFormat = 0;             // GL internal format of the blocks, 0 for raw pixels
+    std::vector<unsigned char> pixels;             // level 0
+    std::vector<std::vector<unsigned char>> mips;  // levels 1..n, each half the previous size
+
+    bool Valid() const { return !pixels.empty(); }
+    int LevelCount() const { return 1 + static_cast<int>(mips.size()); }
+    int LevelWidth(int level) const { return std::max(1, width >> level); }
+    int LevelHeight(int level) const { return std::max(1, height >> level); }
+    const unsigned char* LevelPixels(int level) const { return level == 0 ? pixels.data() : mips[level - 1].data(); }
+};
+
+template <typename T>
+using AssetFuture = std::shared_future<std::shared_ptr<const T>>;
+
+// Loads files on background threads and hands them back through futures. Everything here is
+// CPU-only (file reads, image decode, model import); GL objects are created by the render thread
+// once IsReady() reports the data is resident in memory.
+class AssetManager {
+public:
+    explicit AssetManager(unsigned int loaderThreads = 2);
+    ~AssetManager();
+    AssetManager(const AssetManager&) = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    AssetFuture<ImageData> LoadImage(const std::filesystem::path& path, AssetPriority priority, int desiredChannels = 0, bool generateMips = false);
+    AssetFuture<std::string> LoadText(const std::filesystem::path& path, AssetPriority priority);
+    // Mipmapped texture, see ReadTexture
+    AssetFuture<ImageData> LoadTexture(const std::filesystem::path& path, AssetPriority priority, bool allowBaked);
+
+    // Queues an arbitrary load function (used for model import). Loads still queued when the
+    // manager is destroyed are cancelled: their futures become ready with a null pointer.
+    template <typename T>
+    AssetFuture<T> Submit(AssetPriority priority, std::function<std::shared_ptr<const T>()> load);
+
+    // Paths under root that were embedded at build time (EmbeddedAssets.h) are served from memory,
+    // unless overrideDirectory (empty for none) has its own copy at the same relative path.
+    // Call once at startup, before the first load.
+    static void SetAssetDirectories(const std::filesystem::path& root, const std::filesystem::path& overrideDirectory);
+
+    // Synchronous helpers, also used by the loader threads themselves
+    static std::shared_ptr<const ImageData> DecodeImage(const std::filesystem::path& path, int desiredChannels = 0, bool generateMips = false);
+    // Reads the block-compressed .ctex baked next to path when allowBaked and it exists, otherwise
+    // decodes path and builds the mips on the CPU
+    static std::shared_ptr<const ImageData> ReadTexture(const std::filesystem::path& path, bool allowBaked);
+    // Fills image.mips with a 2x2 box-filtered chain down to 1x1
+    static void GenerateMips(ImageData& image);
+    static std::shared_ptr<const std::string> ReadText(const std::filesystem::path& path);
+
+    template <typename T>
+    static bool IsReady(const AssetFuture<T>& future) {
+        return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    int PendingCount() const { return pending.load(); }
+
+private:
+    struct Request {
+        AssetPriority priority;
+        uint64_t sequence;
+        std::function<void()> work;
+        std::function<void()> cancel; // fulfils the promise without running work
+
+        // Highest priority first, then submission order
+        bool operator<(const Request& other) const {
+            if (priority != other.priority) return priority < other.priority;
+            return sequence > other.sequence;
+        }
+    };
+
+    // The embedded copy of path, or nullptr with diskPath set to the file to read instead
+    static const EmbeddedFile* resolve(const std::filesystem::path& path, std::filesystem::path& diskPath);
+
+    static std::filesystem::path assetRoot, overrideRoot;
+
+    void enqueue(AssetPriority priority, std::function<void()> work, std::function<void()> cancel);
+    void loaderLoop();
+
+    std::vector<std::thread> loaders;
+    std::priority_queue<Request> requests;
+    std::mutex mutex;
+    std::condition_variable available;
+    uint64_t nextSequence = 0;
+    std::atomic<int> pending{ 0 };
+    bool stopping = false;
+};
+
+template <typename T>
+AssetFuture<T> AssetManager::Submit(AssetPriority priority, std::function<std::shared_ptr<const T>()> load) {
+    auto promise = std::make_shared<std::promise<std::shared_ptr<const T>>>();
+    AssetFuture<T> future = promise->get_future().share();
+    enqueue(priority, [promise, load = std::move(load)] {
+        try {
+            promise->set_value(load());
+        }
+        catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+        }, [promise] { promise->set_value(nullptr); });
+    return future;
+}
+
+#endif
@@ -0,0 +1,324 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AssetManager.h"
+#include "GLExtensions.h"
+#include "HeadlessContext.h"
+#include "Input.h"
+#include "InputRecording.h"
+#include "JobSystem.h"
+#include "MemoryTracker.h"
+#include "ModelLoader.h"
+#include "Profiler.h"
+#include "Renderer.h"
+#include "Simulation.h"
+
+bool ParseBenchmarkOptions(int argc, char** argv, BenchmarkOptions& options) {
+    bool benchmark = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.frames = std::max(1, std::atoi(argv[++i]));
+            }
+        }
+        else if (std::strcmp(argv[i], "--benchmark-size") == 0 && i + 1 < argc) {
+            int width = 0, height = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                options.width = width;
+                options.height = height;
+            }
+        }
+        else if (std::strcmp(argv[i], "--benchmark-out") == 0 && i + 1 < argc) {
+            options.reportPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            options.replayPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--frame-time-target") == 0 && i + 1 < argc) {
+            options.frameTimeTargetMs = std::max(0.0, std::atof(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--memory-breakdown") == 0 && i + 1 < argc) {
+            options.memoryBreakdownPath = argv[++i];
+        }
+    }
+    ParseCaptureOptions(argc, argv, options.capture);
+    return benchmark;
+}
+
+namespace {
+
+// ----- Scripted scenario ----- //
+// Free camera orbiting while the carousel spins up, a mounted ride on both horses, then an orbit
+// the other way while it slows down. Expressed as fractions of the run so any frame count works.
+InputFrame scriptedInput(int frame, int frameCount) {
+    InputFrame input;
+    float t = static_cast<float>(frame) / static_cast<float>(frameCount);
+    auto press = [&input](int key) { input.down.set(key); input.pressed.set(key); };
+    auto at = [frame, frameCount](float mark) { return frame == static_cast<int>(mark * frameCount); };
+
+    if (t < 0.35f) {
+        // Strafing right while turning left circles the carousel (0.05 units/tick at radius ~8)
+        input.down.set(GLFW_KEY_RIGHT);
+        input.down.set(GLFW_KEY_D);
+        input.mouseDelta.x = -3.6f;
+    }
+    else if (t < 0.7f) {
+        if (at(0.35f)) press(GLFW_KEY_C);    // mount
+        if (at(0.525f)) press(GLFW_KEY_TAB); // other horse
+        input.mouseDelta.x = 0.5f;
+    }
+    else {
+        if (at(0.7f)) press(GLFW_KEY_C);     // back to free camera
+        input.down.set(GLFW_KEY_LEFT);
+        input.down.set(GLFW_KEY_A);
+        input.mouseDelta.x = 3.6f;
+    }
+    return input;
+}
+
+struct Summary {
+    double mean = 0.0, p50 = 0.0, p90 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+Summary summarize(std::vector<double> samples) {
+    Summary summary;
+    if (samples.empty()) return summary;
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    };
+    summary.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    summary.p50 = percentile(0.50);
+    summary.p90 = percentile(0.90);
+    summary.p95 = percentile(0.95);
+    summary.p99 = percentile(0.99);
+    summary.max = samples.back();
+    return summary;
+}
+
+void writeSummary(std::ostream& out, const char* name, const std::vector<double>& samples, bool last = false) {
+    Summary s = summarize(samples);
+    out << "  \"" << name << "\": { \"mean\": " << s.mean << ", \"p50\": " << s.p50 << ", \"p90\": " << s.p90
+        << ", \"p95\": " << s.p95 << ", \"p99\": " << s.p99 << ", \"max\": " << s.max << " }" << (last ? "\n" : ",\n");
+}
+
+double millisecondsBetween(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+// Quoted JSON string; paths and driver strings may contain quotes, backslashes or control characters
+std::string jsonString(const std::string& text) {
+    std::string escaped = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        }
+        else escaped += c;
+    }
+    return escaped + "\"";
+}
+
+}
+
+bool RenderUntilLoaded(Renderer& renderer, JobSystem& jobs, int width, int height, double timeoutSeconds,
+    std::chrono::steady_clock::time_point startTime) {
+    FrameSnapshot loadingFrame;
+    Simulation(jobs).Tick(InputFrame(), loadingFrame);
+    bool firstFrame = true;
+    while (!renderer.IsFullyLoaded()) {
+        if (millisecondsBetween(startTime, std::chrono::steady_clock::now()) > timeoutSeconds * 1000.0) {
+            std::cerr << "[Benchmark] Assets did not finish loading within " << timeoutSeconds << " s" << std::endl;
+            return false;
+        }
+        renderer.RenderFrame(loadingFrame, width, height);
+        glFinish();
+        if (firstFrame) {
+            renderer.FramePresented();
+            firstFrame = false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+int RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& modelPath,
+    const std::filesystem::path& assetRoot, std::chrono::steady_clock::time_point startTime) {
+    InputRecording replay;
+    if (!options.replayPath.empty() && !replay.Load(options.replayPath)) {
+        return -1;
+    }
+    bool replaying = replay.GetTickCount() > 0;
+
+    HeadlessContext context;
+    if (!context.Create(options.width, options.height)) {
+        return -1;
+    }
+
+    JobSystem jobs;
+    AssetManager assets;
+    bool bakedTextures = HasGLExtension("GL_EXT_texture_compression_s3tc");
+    AssetFuture<ModelData> modelFuture = assets.Submit<ModelData>(AssetPriority::Normal, [modelPath, &jobs, bakedTextures] {
+        return ModelLoader::Import(modelPath.string(), jobs, bakedTextures);
+        });
+
+    Renderer renderer(assetRoot, assets, modelFuture, jobs, startTime);
+    renderer.SetOutputFramebuffer(context.GetFramebuffer());
+    renderer.SetFrameTimeTarget(options.frameTimeTargetMs);
+    // The sequence starts with the first measured frame
+    CaptureOptions captureOptions = options.capture;
+    captureOptions.interval = 0;
+    FrameCapture* capture = options.capture.interval > 0 ? &renderer.EnableCapture(captureOptions) : nullptr;
+
+    // ----- Load: keep rendering the initial view until every asset is on the GPU ----- //
+    if (!RenderUntilLoaded(renderer, jobs, options.width, options.height, options.loadTimeoutSeconds, startTime)) {
+        return -1;
+    }
+    double fullyLoadedMs = millisecondsBetween(startTime, std::chrono::steady_clock::now());
+    std::cout << "[Benchmark] Everything resident after " << fullyLoadedMs << " ms, running "
+        << (replaying ? replay.GetTickCount() : options.warmupFrames + options.frames) << " frames at " << options.width << "x" << options.height << std::endl;
+
+    // ----- Measured run ----- //
+    // At most FramesInFlight frames are queued, like a swap chain would allow; each slot's fence is
+    // waited on just before the slot is reused. GPU time is the sum of the renderer's pass timers,
+    // which GpuTimers reads back GpuTimers::FramesInFlight frames late.
+    constexpr int FramesInFlight = 2;
+    GLsync fences[FramesInFlight] = {};
+
+    std::vector<double> frameMs, cpuMs, gpuMs, drawCalls, triangles, culledMeshes, renderScale, glIssued, glElided, captureCpuMs;
+    frameMs.reserve(options.frames);
+    cpuMs.reserve(options.frames);
+    gpuMs.reserve(options.frames);
+
+    auto retire = [&](int slot) {
+        if (fences[slot]) {
+            glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 10'000'000'000ull);
+            glDeleteSync(fences[slot]);
+            fences[slot] = nullptr;
+        }
+    };
+
+    Simulation simulation(jobs);
+    const ModelData& modelData = *modelFuture.get();
+    simulation.SetModel(modelData.nodes, modelData.meshes.size(), modelData.bulbPositions);
+    FrameSnapshot frame;
+    // A replay is measured as recorded, its first ticks double as the warm-up
+    int totalFrames = replaying ? static_cast<int>(replay.GetTickCount()) : options.warmupFrames + options.frames;
+    int warmupFrames = replaying ? std::min(options.warmupFrames, totalFrames / 10) : options.warmupFrames;
+    jobs.SampleUtilization(); // start the utilization window at the measured run
+    auto previousStart = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < totalFrames; ++i) {
+        int slot = i % FramesInFlight;
+        retire(slot);
+
+        bool measured = i >= warmupFrames;
+        auto frameStart = std::chrono::steady_clock::now();
+        if (i > warmupFrames) frameMs.push_back(millisecondsBetween(previousStart, frameStart)); // previous frame
+        previousStart = frameStart;
+
+        PROFILE_SCOPE("Frame");
+        if (capture && i == warmupFrames) capture->SetInterval(options.capture.interval);
+        simulation.Tick(replaying ? replay.GetFrame(i) : scriptedInput(i, totalFrames), frame);
+        renderer.RenderFrame(frame, options.width, options.height);
+        fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+        // The pass times read back by this frame belong to an earlier one; the last few measured
+        // frames are never read back and a frame with a pass still pending is left out
+        const GpuTimers& gpuTimers = renderer.GetGpuTimers();
+        if (i - GpuTimers::FramesInFlight >= warmupFrames && gpuTimers.IsLastFrameComplete()) {
+            gpuMs.push_back(gpuTimers.GetLastFrameMs());
+        }
+
+        if (measured) {
+            cpuMs.push_back(millisecondsBetween(frameStart, std::chrono::steady_clock::now()));
+            const RenderStats& stats = renderer.GetLastFrameStats();
+            drawCalls.push_back(stats.drawCalls);
+            triangles.push_back(static_cast<double>(stats.triangles));
+            culledMeshes.push_back(static_cast<double>(stats.culledMeshes));
+            renderScale.push_back(stats.renderScale);
+            if (capture) captureCpuMs.push_back(capture->GetLastCpuMs());
+            // Counted up to the previous frame, the last one is still open
+            glIssued.push_back(renderer.GetGLStateCounters().issued);
+            glElided.push_back(renderer.GetGLStateCounters().elided);
+        }
+    }
+    for (int slot = 0; slot < FramesInFlight; ++slot) {
+        retire(slot);
+    }
+    // The interval ending at the last frame start misses the last frame, close it here
+    frameMs.push_back(millisecondsBetween(previousStart, std::chrono::steady_clock::now()));
+    float utilization = jobs.SampleUtilization();
+    if (capture) capture->Flush(); // every file written before the counts are reported
+
+    // ----- Report ----- //
+    std::ofstream report(options.reportPath);
+    if (!report) {
+        std::cerr << "[Benchmark] Could not write " << options.reportPath.string() << std::endl;
+        return -1;
+    }
+    const LoadTimes& loadTimes = renderer.GetLoadTimes();
+    report << "{\n";
+    report << "  \"frames\": " << totalFrames - warmupFrames << ",\n";
+    report << "  \"scenario\": " << jsonString(replaying ? options.replayPath.filename().string() : std::string("scripted")) << ",\n";
+    report << "  \"width\": " << options.width << ",\n";
+    report << "  \"height\": " << options.height << ",\n";
+    report << "  \"frameTimeTargetMs\": " << options.frameTimeTargetMs << ",\n";
+    report << "  \"context\": \"" << context.GetBackendName() << "\",\n";
+    report << "  \"renderer\": " << jsonString(reinterpret_cast<const char*>(glGetString(GL_RENDERER))) << ",\n";
+    report << "  \"loadTimes\": { \"firstFrameMs\": " << loadTimes.firstFrameMs << ", \"environmentMs\": " << loadTimes.environmentMs
+        << ", \"carouselMs\": " << loadTimes.carouselMs << ", \"fullyLoadedMs\": " << fullyLoadedMs << " },\n";
+    writeSummary(report, "frameMs", frameMs);
+    writeSummary(report, "cpuMs", cpuMs);
+    writeSummary(report, "gpuMs", gpuMs);
+    writeSummary(report, "drawCalls", drawCalls);
+    writeSummary(report, "triangles", triangles);
+    writeSummary(report, "culledMeshes", culledMeshes);
+    writeSummary(report, "renderScale", renderScale);
+    if (capture) writeSummary(report, "captureCpuMs", captureCpuMs);
+    writeSummary(report, "glCallsIssued", glIssued);
+    writeSummary(report, "glCallsElided", glElided);
+    report << "  \"gpuPasses\": ";
+    renderer.GetGpuTimers().WriteJson(report, "  ");
+    report << ",\n";
+    const PostProcess& post = renderer.GetPostProcess();
+    report << "  \"postProcess\": { \"averageMs\": " << post.GetAverageMs() << ", \"budgetMs\": " << PostProcess::BudgetMs
+        << ", \"withinBudget\": " << (post.GetAverageMs() <= PostProcess::BudgetMs ? "true" : "false")
+        << ", \"bloomLevels\": " << post.GetBloomLevelCount() << " },\n";
+    if (capture) {
+        report << "  \"capture\": { \"interval\": " << options.capture.interval << ", \"format\": \""
+            << (options.capture.format == CaptureFormat::Png ? "png" : "raw") << "\", \"captured\": " << capture->GetCapturedCount()
+            << ", \"written\": " << capture->GetWrittenCount() << ", \"failed\": " << capture->GetFailedCount() << ", \"dropped\": " << capture->GetDroppedCount()
+            << ", \"gpuAverageMs\": " << capture->GetAverageGpuMs() << ", \"encodeAverageMs\": " << capture->GetAverageEncodeMs() << " },\n";
+    }
+    report << "  \"memory\": ";
+    MemoryTracker::WriteJson(report, "  ");
+    report << ",\n";
+    report << "  \"jobWorkerUtilization\": " << utilization << "\n";
+    report << "}\n";
+
+    Summary frameSummary = summarize(frameMs), gpuSummary = summarize(gpuMs);
+    std::cout << "[Benchmark] frame p50 " << frameSummary.p50 << " ms, p99 " << frameSummary.p99 << " ms, GPU p50 "
+        << gpuSummary.p50 << " ms, report written to " << options.reportPath.string() << std::endl;
+    std::cout << "[Memory] " << MemoryTracker::FormatSummary() << std::endl;
+    if (!options.memoryBreakdownPath.empty()) {
+        std::ofstream breakdown(options.memoryBreakdownPath);
+        MemoryTracker::WriteBreakdown(breakdown);
+    }
+    return 0;
+}
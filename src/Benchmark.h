@@ -0,0 +1,41 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <chrono>
+#include <filesystem>
+#include "FrameCapture.h"
+
+struct BenchmarkOptions {
+    int frames = 1200;           // measured frames, 20 s of simulation at the fixed tick
+    int warmupFrames = 60;       // rendered after loading but not measured
+    int width = 1280, height = 720;
+    double loadTimeoutSeconds = 120.0;
+    std::filesystem::path reportPath = "benchmark.json";
+    std::filesystem::path replayPath;  // recorded input (--record) instead of the built-in script
+    double frameTimeTargetMs = 0.0;    // dynamic resolution, off so runs compare at a fixed resolution
+    CaptureOptions capture;            // --capture-every saves every nth measured frame
+    std::filesystem::path memoryBreakdownPath; // every tracked allocation after the run, empty for none
+};
+
+// Reads --benchmark [frames], --benchmark-size WxH, --benchmark-out <file>, --replay <file>,
+// --frame-time-target <ms> and --memory-breakdown <file>, plus the capture options (ParseCaptureOptions).
+// Returns true when --benchmark was given.
+bool ParseBenchmarkOptions(int argc, char** argv, BenchmarkOptions& options);
+
+class JobSystem;
+class Renderer;
+
+// Renders the initial view into the current framebuffer until every asset is on the GPU, the
+// way a headless run starts. Returns false after timeoutSeconds since startTime.
+bool RenderUntilLoaded(Renderer& renderer, JobSystem& jobs, int width, int height, double timeoutSeconds,
+    std::chrono::steady_clock::time_point startTime);
+
+// Headless run: offscreen context, no vsync, everything loaded before measuring, then a scripted
+// camera/carousel scenario (free orbit, mounted ride, orbit back) driven through the simulation
+// one tick per frame so every run renders the same frames. Writes a JSON report with CPU, GPU
+// and wall frame time percentiles, draw calls and load times. With a replay the recorded ticks
+// replace the script and set the frame count. Returns the process exit code.
+int RunBenchmark(const BenchmarkOptions& options, const std::filesystem::path& modelPath,
+    const std::filesystem::path& assetRoot, std::chrono::steady_clock::time_point startTime);
+
+#endif
@@ -0,0 +1,93 @@
+#include "CompressedTexture.h"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+constexpr char Magic[4] = { 'C', 'T', 'X', '2' };
+constexpr uint32_t Version = 1;
+}
+
+size_t CompressedBlockBytes(unsigned int glInternalFormat) {
+    switch (glInternalFormat) {
+    case CompressedFormatBC1: return 8;
+    case CompressedFormatBC5: return 16;
+    default: return 0;
+    }
+}
+
+size_t CompressedLevelSize(unsigned int glInternalFormat, int width, int height) {
+    size_t blocksWide = (static_cast<size_t>(width) + 3) / 4;
+    size_t blocksHigh = (static_cast<size_t>(height) + 3) / 4;
+    return blocksWide * blocksHigh * CompressedBlockBytes(glInternalFormat);
+}
+
+std::filesystem::path BakedTexturePath(const std::filesystem::path& sourceImage) {
+    std::filesystem::path baked = sourceImage;
+    return baked.replace_extension(".ctex");
+}
+
+bool WriteCompressedTexture(const std::filesystem::path& path, const ImageData& image) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open file for writing: " << path.string() << std::endl;
+        return false;
+    }
+
+    CompressedTextureHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.glInternalFormat = image.compressedFormat;
+    header.width = static_cast<uint32_t>(image.width);
+    header.height = static_cast<uint32_t>(image.height);
+    header.levelCount = static_cast<uint32_t>(image.LevelCount());
+
+    std::vector<CompressedLevelIndex> index(header.levelCount);
+    uint64_t offset = sizeof(header) + sizeof(CompressedLevelIndex) * index.size();
+    for (int level = 0; level < image.LevelCount(); ++level) {
+        index[level].offset = offset;
+        index[level].size = CompressedLevelSize(image.compressedFormat, image.LevelWidth(level), image.LevelHeight(level));
+        offset += index[level].size;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(index.data()), sizeof(CompressedLevelIndex) * index.size());
+    for (int level = 0; level < image.LevelCount(); ++level) {
+        file.write(reinterpret_cast<const char*>(image.LevelPixels(level)), index[level].size);
+    }
+    return static_cast<bool>(file);
+}
+
+std::shared_ptr<const ImageData> ReadCompressedTexture(const std::filesystem::path& path) {
+    auto image = std::make_shared<ImageData>();
+    std::ifstream file(path, std::ios::binary);
+    CompressedTextureHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.version != Version ||
+        CompressedBlockBytes(header.glInternalFormat) == 0 || header.levelCount == 0 || header.levelCount > 32) {
+        std::cerr << "Invalid baked texture: " << path.string() << std::endl;
+        return image;
+    }
+
+    std::vector<CompressedLevelIndex> index(header.levelCount);
+    file.read(reinterpret_cast<char*>(index.data()), sizeof(CompressedLevelIndex) * index.size());
+
+    ImageData result;
+    result.width = static_cast<int>(header.width);
+    result.height = static_cast<int>(header.height);
+    result.compressedFormat = header.glInternalFormat;
+    for (uint32_t level = 0; level < header.levelCount; ++level) {
+        size_t expected = CompressedLevelSize(header.glInternalFormat, result.LevelWidth(level), result.LevelHeight(level));
+        std::vector<unsigned char> blocks(expected);
+        if (index[level].size != expected || !file.seekg(static_cast<std::streamoff>(index[level].offset)) ||
+            !file.read(reinterpret_cast<char*>(blocks.data()), expected)) {
+            std::cerr << "Truncated baked texture: " << path.string() << std::endl;
+            return image;
+        }
+        if (level == 0) result.pixels = std::move(blocks);
+        else result.mips.push_back(std::move(blocks));
+    }
+
+    *image = std::move(result);
+    return image;
+}
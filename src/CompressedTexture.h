@@ -0,0 +1,41 @@
+#ifndef COMPRESSED_TEXTURE_H
+#define COMPRESSED_TEXTURE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include "AssetManager.h"
+
+// GL internal formats produced by carousel_bake (tools/TextureBaker.cpp)
+constexpr unsigned int CompressedFormatBC1 = 0x83F0; // GL_COMPRESSED_RGB_S3TC_DXT1_EXT, base color
+constexpr unsigned int CompressedFormatBC5 = 0x8DBD; // GL_COMPRESSED_RG_RGTC2, tangent-space normal XY
+
+// Baked texture container (.ctex). Same layout idea as KTX2: a fixed header, a level index
+// with the byte range of every mip, then the block data, so the runtime uploads without decoding.
+struct CompressedTextureHeader {
+    char magic[4];          // "CTX2"
+    uint32_t version;
+    uint32_t glInternalFormat;
+    uint32_t width;
+    uint32_t height;
+    uint32_t levelCount;
+};
+
+struct CompressedLevelIndex {
+    uint64_t offset;        // from the start of the file
+    uint64_t size;
+};
+
+// Bytes per 4x4 block, 0 if the format is not one we bake
+size_t CompressedBlockBytes(unsigned int glInternalFormat);
+size_t CompressedLevelSize(unsigned int glInternalFormat, int width, int height);
+
+// foo/bar.jpg -> foo/bar.ctex
+std::filesystem::path BakedTexturePath(const std::filesystem::path& sourceImage);
+
+// Levels are stored in ImageData::pixels / ImageData::mips with compressedFormat set
+bool WriteCompressedTexture(const std::filesystem::path& path, const ImageData& image);
+std::shared_ptr<const ImageData> ReadCompressedTexture(const std::filesystem::path& path);
+
+#endif
@@ -0,0 +1,30 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr double DeadBand = 0.05;  // +-5% around the target leaves the scale alone
+constexpr float GainDown = 0.5f;   // fraction of the way to the ideal scale per frame
+constexpr float GainUp = 0.1f;
+}
+
+DynamicResolution::DynamicResolution(double targetMs)
+    : targetMs(targetMs) {
+    history.fill(MaxScale);
+}
+
+float DynamicResolution::Update(double gpuFrameMs) {
+    // The measurement is of the frame rendered FramesInFlight frames ago, whose scale is the oldest entry
+    float measuredScale = history[historyNext];
+    if (gpuFrameMs > 0.0 && std::abs(gpuFrameMs / targetMs - 1.0) > DeadBand) {
+        float ideal = measuredScale * static_cast<float>(std::sqrt(targetMs / gpuFrameMs));
+        ideal = std::clamp(ideal, MinScale, MaxScale);
+        scale += (ideal - scale) * (ideal < scale ? GainDown : GainUp);
+        // Snap to the ends so the scale reaches exactly full resolution again
+        if (MaxScale - scale < 0.005f) scale = MaxScale;
+        if (scale - MinScale < 0.005f) scale = MinScale;
+    }
+    history[historyNext] = scale;
+    historyNext = (historyNext + 1) % FramesInFlight;
+    return scale;
+}
@@ -0,0 +1,35 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <array>
+
+// Picks the scale of the scene's render target from the measured GPU frame time, so a
+// fill-rate-bound machine trades resolution for frame rate instead of missing deadlines. GPU
+// time is taken as proportional to the pixel count, so the scale that would have hit the target
+// is the measured frame's scale times sqrt(target / measured). The controller moves part of the
+// way there every frame: quickly down, slowly up, and not at all inside a small dead band, so
+// the scale settles instead of oscillating on noise. Measurements arrive FramesInFlight frames
+// late (GpuTimers), each is compared with the scale that frame was rendered at.
+class DynamicResolution {
+public:
+    static constexpr double DefaultTargetMs = 14.0; // a 60 Hz frame with room for the CPU and swap
+    static constexpr float MinScale = 0.5f, MaxScale = 1.0f;
+    static constexpr int FramesInFlight = 3;        // GpuTimers::FramesInFlight
+
+    explicit DynamicResolution(double targetMs);
+
+    // Call once per frame with the GPU time read back this frame, or <= 0 when none is complete.
+    // Returns the scale to render this frame at.
+    float Update(double gpuFrameMs);
+
+    float GetScale() const { return scale; }
+    double GetTargetMs() const { return targetMs; }
+
+private:
+    double targetMs;
+    float scale = MaxScale;
+    std::array<float, FramesInFlight> history; // scales of the frames still in flight
+    int historyNext = 0;
+};
+
+#endif
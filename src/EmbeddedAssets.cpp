@@ -0,0 +1,17 @@
+#include "EmbeddedAssets.h"
+#include <cstring>
+#include "EmbeddedAssetData.h"
+
+const EmbeddedFile* FindEmbeddedFile(const std::string& relativePath) {
+    // A dozen entries, a linear scan is all it takes
+    for (const EmbeddedFile& file : EmbeddedFiles) {
+        if (std::strcmp(file.path, relativePath.c_str()) == 0) {
+            return &file;
+        }
+    }
+    return nullptr;
+}
+
+size_t EmbeddedFileCount() {
+    return sizeof(EmbeddedFiles) / sizeof(EmbeddedFiles[0]);
+}
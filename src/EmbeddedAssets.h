@@ -0,0 +1,19 @@
+#ifndef EMBEDDED_ASSETS_H
+#define EMBEDDED_ASSETS_H
+
+#include <cstddef>
+#include <string>
+
+// A file from assets/ compiled into the executable (see cmake/EmbedAssets.cmake). data is
+// followed by a zero byte that size does not count.
+struct EmbeddedFile {
+    const char* path; // relative to assets/, forward slashes, e.g. "shaders/ground.fs"
+    const unsigned char* data;
+    size_t size;
+};
+
+// nullptr when the file was not embedded
+const EmbeddedFile* FindEmbeddedFile(const std::string& relativePath);
+size_t EmbeddedFileCount();
+
+#endif
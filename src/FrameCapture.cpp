@@ -0,0 +1,229 @@
+#include "FrameCapture.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+// stb initializes its write context with { 0 }, which -Wextra flags
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+#endif
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+#include "Profiler.h"
+
+namespace {
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+}
+
+void ParseCaptureOptions(int argc, char** argv, CaptureOptions& options) {
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--capture-dir") == 0) options.directory = argv[++i];
+        else if (std::strcmp(argv[i], "--capture-format") == 0) {
+            options.format = std::strcmp(argv[++i], "raw") == 0 ? CaptureFormat::Raw : CaptureFormat::Png;
+        }
+        else if (std::strcmp(argv[i], "--capture-every") == 0) options.interval = std::max(0, std::atoi(argv[++i]));
+    }
+}
+
+FrameCapture::FrameCapture(GpuTimers& timers, const CaptureOptions& options)
+    : timers(timers), options(options) {
+    capturePass = timers.AddPass("capture");
+    for (int i = 0; i < ReadbackBufferCount; ++i) {
+        glGenBuffers(1, &readbacks[i].pbo);
+        // Sized by the first frame captured into it
+        readbacks[i].memory = TrackedMemory(MemoryCategory::Staging, "frame capture", "readback buffer " + std::to_string(i), "RGBA8", 0);
+    }
+    encoder = std::thread(&FrameCapture::encoderLoop, this);
+}
+
+FrameCapture::~FrameCapture() {
+    Flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    encoder.join();
+    for (Readback& readback : readbacks) {
+        glDeleteBuffers(1, &readback.pbo);
+    }
+    if (captured > 0) {
+        std::cout << "[Capture] " << written << " frames written to " << options.directory.string() << ", " << failed
+            << " failed, " << dropped << " dropped, encoding averaged " << GetAverageEncodeMs() << " ms" << std::endl;
+    }
+}
+
+void FrameCapture::SetInterval(int frames) {
+    options.interval = std::max(0, frames);
+    sequenceFrame = 0;
+}
+
+void FrameCapture::Capture(GLuint framebuffer, int width, int height) {
+    PROFILE_SCOPE("Frame capture");
+    auto start = std::chrono::steady_clock::now();
+    ++frameIndex;
+    // Oldest first, so files are queued in frame order
+    for (int i = 0; i < ReadbackBufferCount; ++i) {
+        retire(readbacks[(nextReadback + i) % ReadbackBufferCount], false);
+    }
+
+    bool screenshot = screenshotRequested.exchange(false);
+    bool sequence = options.interval > 0 && sequenceFrame % options.interval == 0;
+    uint64_t fileNumber = screenshot ? frameIndex : sequenceFrame;
+    if (options.interval > 0) ++sequenceFrame;
+    if ((screenshot || sequence) && width > 0 && height > 0) {
+        Readback& readback = readbacks[nextReadback];
+        if (readback.fence) {
+            // Every buffer still in flight, skip the frame rather than wait for the GPU
+            ++dropped;
+            if (screenshot) screenshotRequested = true;
+        }
+        else {
+            if (!directoryCreated) {
+                std::error_code error;
+                std::filesystem::create_directories(options.directory, error);
+                directoryCreated = true;
+            }
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s_%06llu.%s", screenshot ? "screenshot" : "frame",
+                static_cast<unsigned long long>(fileNumber), options.format == CaptureFormat::Png ? "png" : "ppm");
+            readback.path = options.directory / name;
+            readback.screenshot = screenshot;
+            readback.width = width;
+            readback.height = height;
+
+            // RGBA rows are always 4-byte aligned, the driver's fast path
+            size_t size = static_cast<size_t>(width) * height * 4;
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+            if (readback.bufferSize != size) {
+                glBufferData(GL_PIXEL_PACK_BUFFER, size, nullptr, GL_STREAM_READ);
+                readback.bufferSize = size;
+                readback.memory.Resize(size);
+            }
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+            glReadBuffer(framebuffer == 0 ? GL_BACK : GL_COLOR_ATTACHMENT0);
+            glPixelStorei(GL_PACK_ALIGNMENT, 4);
+            {
+                GpuTimers::Scope gpuScope(timers, capturePass);
+                glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            nextReadback = (nextReadback + 1) % ReadbackBufferCount;
+            ++captured;
+        }
+    }
+    lastCpuMs = millisecondsSince(start);
+}
+
+bool FrameCapture::retire(Readback& readback, bool wait) {
+    if (!readback.fence) return true;
+    GLenum status = wait ? glClientWaitSync(readback.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull)
+                         : glClientWaitSync(readback.fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) return false;
+    glDeleteSync(readback.fence);
+    readback.fence = nullptr;
+
+    EncodeJob job{ {}, readback.width, readback.height, readback.path, readback.screenshot };
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.pbo);
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, readback.bufferSize, GL_MAP_READ_BIT);
+    if (mapped) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(mapped);
+        job.pixels.assign(bytes, bytes + readback.width * static_cast<size_t>(readback.height) * 4);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!mapped) {
+        ++dropped;
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (jobs.size() >= MaxQueuedFrames) {
+            ++dropped; // the encoder is behind, keep its queue (and memory) bounded
+            return true;
+        }
+        jobs.push_back(std::move(job));
+    }
+    available.notify_one();
+    return true;
+}
+
+void FrameCapture::Flush() {
+    PROFILE_SCOPE("Frame capture flush");
+    for (int i = 0; i < ReadbackBufferCount; ++i) {
+        retire(readbacks[(nextReadback + i) % ReadbackBufferCount], true);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    drained.wait(lock, [this] { return jobs.empty() && !encoding; });
+}
+
+double FrameCapture::GetAverageEncodeMs() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t encoded = written + failed;
+    return encoded > 0 ? encodeMsTotal / encoded : 0.0;
+}
+
+void FrameCapture::encoderLoop() {
+    Profiler::SetThreadName("Capture encoder");
+    for (;;) {
+        EncodeJob job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this] { return stopping || !jobs.empty(); });
+            if (jobs.empty()) return;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            encoding = true;
+        }
+        auto start = std::chrono::steady_clock::now();
+        bool ok = encode(job);
+        double ms = millisecondsSince(start);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            encoding = false;
+            encodeMsTotal += ms;
+            ++(ok ? written : failed);
+        }
+        drained.notify_all();
+    }
+}
+
+bool FrameCapture::encode(const EncodeJob& job) {
+    PROFILE_SCOPE("Encode frame");
+    // GL rows start at the bottom, image files at the top; alpha is dropped
+    std::vector<unsigned char> rgb(static_cast<size_t>(job.width) * job.height * 3);
+    for (int y = 0; y < job.height; ++y) {
+        const unsigned char* source = &job.pixels[static_cast<size_t>(job.height - 1 - y) * job.width * 4];
+        unsigned char* destination = &rgb[static_cast<size_t>(y) * job.width * 3];
+        for (int x = 0; x < job.width; ++x) {
+            destination[x * 3 + 0] = source[x * 4 + 0];
+            destination[x * 3 + 1] = source[x * 4 + 1];
+            destination[x * 3 + 2] = source[x * 4 + 2];
+        }
+    }
+
+    bool ok;
+    if (options.format == CaptureFormat::Png) {
+        ok = stbi_write_png(job.path.string().c_str(), job.width, job.height, 3, rgb.data(), job.width * 3) != 0;
+    }
+    else {
+        std::ofstream out(job.path, std::ios::binary);
+        out << "P6\n" << job.width << " " << job.height << "\n255\n";
+        out.write(reinterpret_cast<const char*>(rgb.data()), static_cast<std::streamsize>(rgb.size()));
+        ok = static_cast<bool>(out);
+    }
+    if (!ok) std::cerr << "[Capture] Could not write " << job.path.string() << std::endl;
+    else if (job.screenshot) std::cout << "[Capture] Saved " << job.path.string() << std::endl;
+    return ok;
+}
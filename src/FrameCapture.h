@@ -0,0 +1,118 @@
+#ifndef FRAME_CAPTURE_H
+#define FRAME_CAPTURE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <glad/glad.h>
+#include "GpuTimers.h"
+#include "MemoryTracker.h"
+
+enum class CaptureFormat {
+    Png,
+    Raw, // binary PPM: a one-line header and the RGB bytes, no compression
+};
+
+struct CaptureOptions {
+    std::filesystem::path directory = "captures";
+    CaptureFormat format = CaptureFormat::Png;
+    int interval = 0; // capture every Nth frame, 1 for a full sequence, 0 for screenshots only
+};
+
+// Reads --capture-dir <dir>, --capture-format png|raw and --capture-every <frames>
+void ParseCaptureOptions(int argc, char** argv, CaptureOptions& options);
+
+// Saves rendered frames without stalling the pipeline. Capture() only queues a glReadPixels into
+// a pixel pack buffer and a fence; a few frames later, once the fence has signaled, the buffer is
+// mapped, its pixels are copied out and handed to an encoder thread that writes the file. The
+// readback is GPU timed as the "capture" pass; the CPU time of Capture() and the encoder's time
+// per file are tracked separately. When every readback buffer is still in flight, or the encoder
+// is MaxQueuedFrames behind, the frame is dropped (and counted) rather than waited for.
+// Capture() and Flush() must only be called on the thread that holds the GL context.
+class FrameCapture {
+public:
+    static constexpr int ReadbackBufferCount = 3;
+    static constexpr size_t MaxQueuedFrames = 8;
+
+    // The "capture" query is added to timers
+    FrameCapture(GpuTimers& timers, const CaptureOptions& options);
+    // Finishes the readbacks in flight and the files queued for encoding
+    ~FrameCapture();
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    // Captures the next frame as a screenshot, safe to call from any thread
+    void RequestScreenshot() { screenshotRequested = true; }
+    // Starts a new sequence of every Nth frame (0 stops it), numbered from the next frame
+    void SetInterval(int frames);
+
+    // Call once per frame once its image is complete in framebuffer (0 for the back buffer)
+    void Capture(GLuint framebuffer, int width, int height);
+    // Waits for every readback in flight and for the encoder to write them
+    void Flush();
+
+    const CaptureOptions& GetOptions() const { return options; }
+    uint64_t GetCapturedCount() const { return captured; }
+    uint64_t GetDroppedCount() const { return dropped; }
+    uint64_t GetWrittenCount() const { return written; }
+    // Frames the encoder could not write (disk full, directory not writable, ...)
+    uint64_t GetFailedCount() const { return failed; }
+    // CPU time of the last Capture(): readbacks issued, buffers mapped and copied
+    double GetLastCpuMs() const { return lastCpuMs; }
+    double GetAverageEncodeMs() const;
+    double GetAverageGpuMs() const { return timers.GetAverageMs(capturePass); }
+
+private:
+    struct Readback {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        size_t bufferSize = 0;
+        int width = 0, height = 0;
+        std::filesystem::path path;
+        bool screenshot = false;
+        TrackedMemory memory;
+    };
+
+    // RGBA rows bottom-up, as read from GL
+    struct EncodeJob {
+        std::vector<unsigned char> pixels;
+        int width = 0, height = 0;
+        std::filesystem::path path;
+        bool screenshot = false; // logged when written
+    };
+
+    // Hands the readback's pixels to the encoder once they have arrived (waiting for them if wait
+    // is set). Returns false while the readback is still in flight.
+    bool retire(Readback& readback, bool wait);
+    void encoderLoop();
+    // Returns false when the file could not be written
+    bool encode(const EncodeJob& job);
+
+    GpuTimers& timers;
+    int capturePass;
+    CaptureOptions options;
+    std::atomic<bool> screenshotRequested{ false };
+    Readback readbacks[ReadbackBufferCount];
+    int nextReadback = 0;
+    uint64_t frameIndex = 0;    // frames seen, names the screenshots
+    uint64_t sequenceFrame = 0; // frames since the sequence started, names its files
+    bool directoryCreated = false; // on the first capture, not just for running the viewer
+    uint64_t captured = 0, dropped = 0;
+    double lastCpuMs = 0.0;
+
+    std::thread encoder;
+    mutable std::mutex mutex;
+    std::condition_variable available, drained;
+    std::deque<EncodeJob> jobs;
+    bool encoding = false, stopping = false;
+    std::atomic<uint64_t> written{ 0 }, failed{ 0 };
+    double encodeMsTotal = 0.0; // guarded by mutex, of written and failed frames
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef FRAME_SNAPSHOT_H
+#define FRAME_SNAPSHOT_H
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Must match MAX_POINT_LIGHTS in ground.fs, shader.fs variants are compiled for up to this many
+constexpr int MaxPointLights = 64;
+
+// What a tick changed compared with the previous one. The bulb flicker is not a change, it follows
+// time, which always advances. With none of these set the frame could be skipped (RenderOnDemand).
+enum SceneChange : uint32_t {
+    SceneChangeCamera = 1 << 0,
+    SceneChangeCarousel = 1 << 1, // rotation or horse animation
+    SceneChangeOverlay = 1 << 2,  // HUD shown or hidden
+    SceneChangeLights = 1 << 3,   // bulbs arrived with the model
+};
+
+// Everything the render thread needs to draw one frame. Produced by the simulation thread
+// and never modified once published, so the renderer can read it without locking.
+struct FrameSnapshot {
+    uint64_t tick = 0;
+    float time = 0.0f;              // simulation time in seconds, drives the bulb flicker
+    uint32_t changes = 0;           // SceneChange flags
+    bool resumedFromIdle = false;   // first tick after an idle wait, its frame interval is not a stutter
+
+    // Camera
+    glm::vec3 cameraPos = glm::vec3(0.0f);
+    glm::mat4 view = glm::mat4(1.0f);
+
+    // Carousel
+    float rotation = 0.0f;          // degrees
+    std::vector<glm::mat4> meshTransforms; // world matrix per model mesh, empty until the model is in
+
+    // Performance overlay, toggled with F3
+    bool showHud = false;
+
+    // Bulb lights in world space
+    int numLights = 0;
+    std::array<glm::vec3, MaxPointLights> lightPositions;
+};
+
+#endif
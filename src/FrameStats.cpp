@@ -0,0 +1,155 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+// ----- LatencyHistogram ----- //
+
+int LatencyHistogram::bucketIndex(uint64_t microseconds) {
+    if (microseconds < SubBucketCount) {
+        return static_cast<int>(microseconds);
+    }
+    int highestBit = 63;
+    while (!(microseconds >> highestBit)) --highestBit;
+    int shift = highestBit - (SubBucketBits - 1); // keeps the top 7 bits, 64..127
+    int index = SubBucketCount + (shift - 1) * (SubBucketCount / 2) + static_cast<int>((microseconds >> shift) - SubBucketCount / 2);
+    return std::min(index, BucketCount - 1);
+}
+
+uint64_t LatencyHistogram::bucketUpperEdge(int index) {
+    if (index < SubBucketCount) {
+        return static_cast<uint64_t>(index);
+    }
+    int offset = index - SubBucketCount;
+    int shift = offset / (SubBucketCount / 2) + 1;
+    uint64_t mantissa = static_cast<uint64_t>(offset % (SubBucketCount / 2) + SubBucketCount / 2);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(double milliseconds) {
+    uint64_t microseconds = static_cast<uint64_t>(std::max(0.0, milliseconds) * 1000.0 + 0.5);
+    ++buckets[bucketIndex(microseconds)];
+    ++count;
+    sumMs += milliseconds;
+    maxMs = std::max(maxMs, milliseconds);
+}
+
+void LatencyHistogram::Clear() {
+    buckets.fill(0);
+    count = 0;
+    sumMs = maxMs = 0.0;
+}
+
+double LatencyHistogram::GetPercentileMs(double fraction) const {
+    if (count == 0) return 0.0;
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * count)));
+    uint64_t seen = 0;
+    for (int index = 0; index < BucketCount; ++index) {
+        seen += buckets[index];
+        if (seen >= target) {
+            return std::min(bucketUpperEdge(index) / 1000.0, maxMs);
+        }
+    }
+    return maxMs;
+}
+
+// ----- FrameStats ----- //
+
+FrameStats::FrameStats(double stutterFactor, uint64_t warmupFrames)
+    : stutterFactor(stutterFactor), warmupFrames(warmupFrames) {}
+
+const char* FrameStats::PhaseName(FramePhase phase) {
+    switch (phase) {
+    case FramePhase::Wait: return "wait";
+    case FramePhase::Render: return "render";
+    case FramePhase::Swap: return "swap";
+    case FramePhase::Gpu: return "gpu";
+    default: return "?";
+    }
+}
+
+bool FrameStats::AddFrame(const FrameTiming& timing) {
+    ++frameCount;
+    bool stutter = false;
+
+    // Compare against the medians before this frame is counted, once there is enough history
+    if (frameCount > warmupFrames) {
+        double median = interval.GetPercentileMs(0.5);
+        if (median > 0.0 && timing.intervalMs > stutterFactor * median) {
+            FramePhase longPhase = FramePhase::Render;
+            double longestExcess = -1.0;
+            for (size_t p = 0; p < phases.size(); ++p) {
+                double excess = timing.phaseMs[p] - phases[p].GetPercentileMs(0.5);
+                if (excess > longestExcess) {
+                    longestExcess = excess;
+                    longPhase = static_cast<FramePhase>(p);
+                }
+            }
+
+            ++stutterCount;
+            stutters.push_back(Stutter{ frameCount, timing, median, longPhase });
+            if (stutters.size() > MaxStuttersKept) stutters.pop_front();
+            stutter = true;
+
+            std::cout << std::fixed << std::setprecision(1) << "[Stutter] frame " << frameCount << ": " << timing.intervalMs
+                << " ms (" << timing.intervalMs / median << "x median), " << PhaseName(longPhase) << " ran long ("
+                << timing.phaseMs[static_cast<size_t>(longPhase)] << " ms vs " << phases[static_cast<size_t>(longPhase)].GetPercentileMs(0.5)
+                << " ms median)" << std::defaultfloat << std::endl;
+        }
+    }
+
+    interval.Record(timing.intervalMs);
+    for (size_t p = 0; p < phases.size(); ++p) {
+        phases[p].Record(timing.phaseMs[p]);
+    }
+    return stutter;
+}
+
+std::string FrameStats::FormatSummary() const {
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(1) << "frame p50 " << interval.GetPercentileMs(0.5)
+        << " | p95 " << interval.GetPercentileMs(0.95) << " | p99 " << interval.GetPercentileMs(0.99)
+        << " | max " << interval.GetMaxMs() << " ms, " << stutterCount << " stutters in " << frameCount << " frames";
+    return summary.str();
+}
+
+bool FrameStats::WriteCsv(const std::filesystem::path& summaryPath, const std::filesystem::path& stutterPath) const {
+    std::ofstream summary(summaryPath);
+    std::ofstream stutterFile(stutterPath);
+    if (!summary || !stutterFile) {
+        std::cerr << "[FrameStats] Could not write " << summaryPath.string() << " / " << stutterPath.string() << std::endl;
+        return false;
+    }
+
+    summary << std::fixed << std::setprecision(3);
+    summary << "series,count,mean_ms,p50_ms,p90_ms,p95_ms,p99_ms,p999_ms,max_ms\n";
+    auto writeRow = [&summary](const char* name, const LatencyHistogram& histogram) {
+        summary << name << "," << histogram.GetCount() << "," << histogram.GetMeanMs() << "," << histogram.GetPercentileMs(0.5) << ","
+            << histogram.GetPercentileMs(0.9) << "," << histogram.GetPercentileMs(0.95) << "," << histogram.GetPercentileMs(0.99) << ","
+            << histogram.GetPercentileMs(0.999) << "," << histogram.GetMaxMs() << "\n";
+    };
+    writeRow("interval", interval);
+    for (size_t p = 0; p < phases.size(); ++p) {
+        writeRow(PhaseName(static_cast<FramePhase>(p)), phases[p]);
+    }
+
+    stutterFile << std::fixed << std::setprecision(3);
+    stutterFile << "frame,interval_ms,median_ms,long_phase";
+    for (size_t p = 0; p < phases.size(); ++p) {
+        stutterFile << "," << PhaseName(static_cast<FramePhase>(p)) << "_ms";
+    }
+    stutterFile << "\n";
+    for (const Stutter& stutter : stutters) {
+        stutterFile << stutter.frame << "," << stutter.timing.intervalMs << "," << stutter.medianMs << "," << PhaseName(stutter.longPhase);
+        for (double ms : stutter.timing.phaseMs) {
+            stutterFile << "," << ms;
+        }
+        stutterFile << "\n";
+    }
+
+    std::cout << "[FrameStats] " << FormatSummary() << ", written to " << summaryPath.string() << " and " << stutterPath.string() << std::endl;
+    return true;
+}
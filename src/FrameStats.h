@@ -0,0 +1,88 @@
+#ifndef FRAME_STATS_H
+#define FRAME_STATS_H
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+
+// Log-linear latency histogram in the style of HdrHistogram: exact below 128 us, then 64 linear
+// sub-buckets per power of two, so any value up to ~35 minutes lands in a bucket at most 1/64
+// (1.6 %) wide. Fixed size, so it can record for days without growing.
+class LatencyHistogram {
+public:
+    void Record(double milliseconds);
+    void Clear();
+
+    uint64_t GetCount() const { return count; }
+    double GetMeanMs() const { return count ? sumMs / count : 0.0; }
+    double GetMaxMs() const { return maxMs; }
+    // Upper edge of the bucket holding the given fraction (0..1) of the samples
+    double GetPercentileMs(double fraction) const;
+
+private:
+    static constexpr int SubBucketBits = 7;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = SubBucketCount + 24 * (SubBucketCount / 2);
+
+    static int bucketIndex(uint64_t microseconds);
+    static uint64_t bucketUpperEdge(int index);
+
+    std::array<uint64_t, BucketCount> buckets = {};
+    uint64_t count = 0;
+    double sumMs = 0.0, maxMs = 0.0;
+};
+
+// Where the time of a presented frame went, as measured by the render thread
+enum class FramePhase {
+    Wait,    // waiting for the next simulation snapshot
+    Render,  // CPU side of RenderFrame
+    Swap,    // glfwSwapBuffers, includes vsync and driver throttling
+    Gpu,     // summed GPU pass time (reported a few frames late by GpuTimers)
+    Count
+};
+
+struct FrameTiming {
+    double intervalMs = 0.0; // present to present
+    std::array<double, static_cast<size_t>(FramePhase::Count)> phaseMs = {};
+};
+
+// Present intervals and phase times of every frame, plus stutter detection: a frame whose
+// interval exceeds stutterFactor x the median interval is flagged together with the phase that
+// ran the most over its own median.
+class FrameStats {
+public:
+    explicit FrameStats(double stutterFactor = 2.0, uint64_t warmupFrames = 120);
+
+    // Returns true when the frame was flagged as a stutter
+    bool AddFrame(const FrameTiming& timing);
+
+    const LatencyHistogram& GetIntervalHistogram() const { return interval; }
+    const LatencyHistogram& GetPhaseHistogram(FramePhase phase) const { return phases[static_cast<size_t>(phase)]; }
+    uint64_t GetStutterCount() const { return stutterCount; }
+    static const char* PhaseName(FramePhase phase);
+
+    // "frame p50 16.6 | p95 17.1 | p99 18.0 | max 40.2 ms, 3 stutters"
+    std::string FormatSummary() const;
+    // Percentiles of every series, and the most recent stutters with their long phase
+    bool WriteCsv(const std::filesystem::path& summaryPath, const std::filesystem::path& stutterPath) const;
+
+private:
+    struct Stutter {
+        uint64_t frame;
+        FrameTiming timing;
+        double medianMs;
+        FramePhase longPhase;
+    };
+    static constexpr size_t MaxStuttersKept = 10000;
+
+    double stutterFactor;
+    uint64_t warmupFrames;
+    uint64_t frameCount = 0, stutterCount = 0;
+    LatencyHistogram interval;
+    std::array<LatencyHistogram, static_cast<size_t>(FramePhase::Count)> phases;
+    std::deque<Stutter> stutters;
+};
+
+#endif
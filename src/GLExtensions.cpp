@@ -0,0 +1,33 @@
+#include "GLExtensions.h"
+#include <glad/glad.h>
+#include <cstring>
+
+static GLProcLoader procLoader = nullptr;
+
+bool HasGLExtension(const char* name) {
+    int count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (int i = 0; i < count; ++i) {
+        const char* extension = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        if (extension && std::strcmp(extension, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int GetGLVersion() {
+    int major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    return major * 10 + minor;
+}
+
+bool LoadGLFunctions(GLProcLoader loader) {
+    procLoader = loader;
+    return gladLoadGLLoader(static_cast<GLADloadproc>(loader)) != 0;
+}
+
+void* GetGLProcAddress(const char* name) {
+    return procLoader ? procLoader(name) : nullptr;
+}
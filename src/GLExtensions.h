@@ -0,0 +1,16 @@
+#ifndef GL_EXTENSIONS_H
+#define GL_EXTENSIONS_H
+
+// glad is generated for plain GL 3.3 core without extensions, so optional features are
+// detected here at runtime. Requires a current context.
+bool HasGLExtension(const char* name);
+// Context version as major * 10 + minor, e.g. 33 or 46
+int GetGLVersion();
+
+typedef void* (*GLProcLoader)(const char* name);
+// gladLoadGLLoader that also keeps the loader around for GetGLProcAddress
+bool LoadGLFunctions(GLProcLoader loader);
+// Entry points glad was not generated with (newer core versions, extensions), nullptr if missing
+void* GetGLProcAddress(const char* name);
+
+#endif
@@ -0,0 +1,152 @@
+#include "GLState.h"
+#include <cstring>
+#include <glm/gtc/type_ptr.hpp>
+
+GLState::GLState() {
+    Invalidate();
+}
+
+void GLState::BeginFrame() {
+    lastFrame = current;
+    current = GLStateCounters();
+}
+
+void GLState::Invalidate() {
+    program = vertexArray = activeUnit = Unknown;
+    for (auto& unit : textures) {
+        unit.fill(Unknown);
+    }
+    depthTest = depthFunc = blend = blendSource = blendDestination = Unknown;
+    uniformBuffers.fill(BufferRange{ Unknown, 0, 0 });
+    programUniforms = nullptr;
+}
+
+bool GLState::changed(GLuint& shadow, GLuint value) {
+    if (shadow == value) {
+        ++current.elided;
+        return false;
+    }
+    shadow = value;
+    ++current.issued;
+    return true;
+}
+
+void GLState::UseProgram(GLuint newProgram) {
+    if (changed(program, newProgram)) {
+        glUseProgram(newProgram);
+    }
+    programUniforms = &uniforms[newProgram];
+}
+
+void GLState::BindVertexArray(GLuint vao) {
+    if (changed(vertexArray, vao)) {
+        glBindVertexArray(vao);
+    }
+}
+
+void GLState::BindTexture(int unit, GLenum target, GLuint texture) {
+    GLuint& shadow = textures[unit][target == GL_TEXTURE_CUBE_MAP ? 1 : 0];
+    if (shadow == texture) {
+        ++current.elided;
+        return;
+    }
+    if (changed(activeUnit, static_cast<GLuint>(unit))) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+    shadow = texture;
+    ++current.issued;
+    glBindTexture(target, texture);
+}
+
+void GLState::SetDepthTest(bool enabled) {
+    if (changed(depthTest, enabled)) {
+        enabled ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+    }
+}
+
+void GLState::SetDepthFunc(GLenum func) {
+    if (changed(depthFunc, func)) {
+        glDepthFunc(func);
+    }
+}
+
+void GLState::SetBlend(bool enabled) {
+    if (changed(blend, enabled)) {
+        enabled ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+    }
+}
+
+void GLState::SetBlendFunc(GLenum source, GLenum destination) {
+    if (blendSource == source && blendDestination == destination) {
+        ++current.elided;
+        return;
+    }
+    blendSource = source;
+    blendDestination = destination;
+    ++current.issued;
+    glBlendFunc(source, destination);
+}
+
+bool GLState::uniformChanged(const std::string& name, const void* value, int words, GLint& location) {
+    auto found = programUniforms->find(name);
+    if (found == programUniforms->end()) {
+        found = programUniforms->emplace(name, Uniform()).first;
+        found->second.location = glGetUniformLocation(program, name.c_str());
+    }
+    Uniform& uniform = found->second;
+    // Inactive uniforms (optimized out of this variant) cost nothing either way
+    if (uniform.location < 0 || (uniform.words == words && std::memcmp(uniform.value.data(), value, words * 4) == 0)) {
+        ++current.elided;
+        return false;
+    }
+    uniform.words = words;
+    std::memcpy(uniform.value.data(), value, words * 4);
+    location = uniform.location;
+    ++current.issued;
+    return true;
+}
+
+void GLState::SetUniform(const std::string& name, int value) {
+    GLint location;
+    if (uniformChanged(name, &value, 1, location)) glUniform1i(location, value);
+}
+
+void GLState::SetUniform(const std::string& name, float value) {
+    GLint location;
+    if (uniformChanged(name, &value, 1, location)) glUniform1f(location, value);
+}
+
+void GLState::SetUniform(const std::string& name, const glm::vec2& value) {
+    GLint location;
+    if (uniformChanged(name, glm::value_ptr(value), 2, location)) glUniform2fv(location, 1, glm::value_ptr(value));
+}
+
+void GLState::SetUniform(const std::string& name, const glm::vec3& value) {
+    GLint location;
+    if (uniformChanged(name, glm::value_ptr(value), 3, location)) glUniform3fv(location, 1, glm::value_ptr(value));
+}
+
+void GLState::SetUniform(const std::string& name, const glm::mat4& value) {
+    GLint location;
+    if (uniformChanged(name, glm::value_ptr(value), 16, location)) glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void GLState::SetUniformBlockBinding(const std::string& block, GLuint binding) {
+    auto inserted = blockBindings[program].emplace(block, Unknown);
+    if (!changed(inserted.first->second, binding)) return;
+    GLuint index = glGetUniformBlockIndex(program, block.c_str());
+    if (index != GL_INVALID_INDEX) {
+        glUniformBlockBinding(program, index, binding);
+    }
+}
+
+void GLState::BindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    BufferRange& range = uniformBuffers[binding];
+    if (range.buffer == buffer && range.offset == offset && range.size == size) {
+        ++current.elided;
+        return;
+    }
+    range = BufferRange{ buffer, offset, size };
+    ++current.issued;
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+}
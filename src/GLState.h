@@ -0,0 +1,92 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Calls made through GLState in one frame
+struct GLStateCounters {
+    int issued = 0; // reached the driver
+    int elided = 0; // matched the shadowed state and were skipped
+};
+
+// Thin shadow of the GL state the renderer touches per frame: bound program and VAO, 2D/cube map
+// texture bindings per unit, uniform buffer ranges, depth and blend state, and the value of every
+// uniform (and uniform block binding) set through it, per program. A call that matches the shadow
+// is skipped. Uniform values live in the program object, so they stay valid across frames;
+// bindings are only trusted until code that bypasses the tracker (asset uploads, VAO setup) runs,
+// after which Invalidate() must be called.
+// Must only be used on the thread that holds the GL context.
+class GLState {
+public:
+    static constexpr int TextureUnits = 8;
+    static constexpr int UniformBufferBindings = 8;
+
+    GLState();
+
+    // Starts a new frame's counters, the previous frame's stay readable
+    void BeginFrame();
+    const GLStateCounters& GetLastFrameCounters() const { return lastFrame; }
+
+    // Forgets bindings and capabilities (not uniform values), the next call of each is issued
+    void Invalidate();
+
+    void UseProgram(GLuint program);
+    void BindVertexArray(GLuint vao);
+    // target is GL_TEXTURE_2D or GL_TEXTURE_CUBE_MAP
+    void BindTexture(int unit, GLenum target, GLuint texture);
+
+    void SetDepthTest(bool enabled);
+    void SetDepthFunc(GLenum func);
+    void SetBlend(bool enabled);
+    void SetBlendFunc(GLenum source, GLenum destination);
+
+    // Uniforms of the current program, looked up by name once per program
+    void SetUniform(const std::string& name, int value);
+    void SetUniform(const std::string& name, float value);
+    void SetUniform(const std::string& name, const glm::vec2& value);
+    void SetUniform(const std::string& name, const glm::vec3& value);
+    void SetUniform(const std::string& name, const glm::mat4& value);
+    // Points the current program's uniform block at an indexed binding, once per program
+    void SetUniformBlockBinding(const std::string& block, GLuint binding);
+    // glBindBufferRange(GL_UNIFORM_BUFFER, ...) for binding < UniformBufferBindings
+    void BindUniformBuffer(GLuint binding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+private:
+    static constexpr GLuint Unknown = ~0u;
+
+    struct Uniform {
+        GLint location = -1;
+        int words = 0;                   // 0 until first set
+        std::array<uint32_t, 16> value;  // raw bits, floats and ints alike
+    };
+
+    // True (and the shadow updated) when the value differs from the last one set
+    bool uniformChanged(const std::string& name, const void* value, int words, GLint& location);
+    bool changed(GLuint& shadow, GLuint value);
+
+    GLStateCounters current, lastFrame;
+
+    GLuint program = Unknown;
+    GLuint vertexArray = Unknown;
+    GLuint activeUnit = Unknown;
+    std::array<std::array<GLuint, 2>, TextureUnits> textures; // [unit][2D, cube map]
+    GLuint depthTest = Unknown, depthFunc = Unknown, blend = Unknown;
+    GLuint blendSource = Unknown, blendDestination = Unknown;
+    struct BufferRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+    };
+    std::array<BufferRange, UniformBufferBindings> uniformBuffers;
+
+    std::unordered_map<GLuint, std::unordered_map<std::string, Uniform>> uniforms;
+    std::unordered_map<std::string, Uniform>* programUniforms = nullptr; // of the current program
+    std::unordered_map<GLuint, std::unordered_map<std::string, GLuint>> blockBindings;
+};
+
+#endif
@@ -0,0 +1,281 @@
+#include "GoldenImages.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "AssetManager.h"
+#include "Benchmark.h"
+#include "GLExtensions.h"
+#include "HeadlessContext.h"
+#include "Input.h"
+#include "JobSystem.h"
+#include "ModelLoader.h"
+#include "Renderer.h"
+#include "Simulation.h"
+
+bool ParseGoldenOptions(int argc, char** argv, GoldenOptions& options) {
+    bool golden = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--golden") == 0) {
+            golden = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.referenceDirectory = argv[++i];
+            }
+        }
+        else if (std::strcmp(argv[i], "--golden-update") == 0) {
+            golden = true;
+            options.update = true;
+        }
+        else if (std::strcmp(argv[i], "--golden-out") == 0 && i + 1 < argc) {
+            options.outputDirectory = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--golden-size") == 0 && i + 1 < argc) {
+            int width = 0, height = 0;
+            if (std::sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0) {
+                options.width = width;
+                options.height = height;
+            }
+        }
+    }
+    return golden;
+}
+
+namespace {
+
+// ----- Scenarios ----- //
+// Tolerances leave room for rasterizer differences between Mesa versions (edge coverage, float
+// rounding in the bloom chain) but not for a changed light, material or transform. The moving
+// scenarios have more edges in motion-dependent places and bulbs under the bloom, so they get
+// a little more.
+struct Scenario {
+    const char* name;
+    int ticks;
+    InputFrame (*input)(int tick);
+    double minPsnr; // dB
+    double minSsim;
+};
+
+void press(InputFrame& input, int key) {
+    input.down.set(key);
+    input.pressed.set(key);
+}
+
+const Scenario Scenarios[] = {
+    // The first frame: free camera in front of the carousel at rest
+    { "start", 1, [](int) { return InputFrame(); }, 40.0, 0.98 },
+    // Spun up for five seconds, horses mid-bob
+    { "spinning", 300, [](int) { InputFrame input; input.down.set(GLFW_KEY_RIGHT); return input; }, 35.0, 0.97 },
+    // Strafing while turning circles the carousel to its side
+    { "orbit", 240, [](int) {
+        InputFrame input;
+        input.down.set(GLFW_KEY_D);
+        input.mouseDelta.x = -3.6f;
+        return input;
+        }, 35.0, 0.97 },
+    // Riding the second horse while the carousel turns
+    { "mounted", 200, [](int tick) {
+        InputFrame input;
+        if (tick == 60) press(input, GLFW_KEY_C);
+        if (tick == 90) press(input, GLFW_KEY_TAB);
+        input.down.set(GLFW_KEY_RIGHT);
+        return input;
+        }, 35.0, 0.97 },
+};
+
+// Tightly packed RGB, top row first
+struct Image {
+    int width = 0, height = 0;
+    std::vector<unsigned char> pixels;
+};
+
+Image readFramebuffer(unsigned int framebuffer, int width, int height) {
+    Image image;
+    image.width = width;
+    image.height = height;
+    std::vector<unsigned char> rows(static_cast<size_t>(width) * height * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rows.data());
+    // GL rows start at the bottom
+    image.pixels.resize(rows.size());
+    size_t rowBytes = static_cast<size_t>(width) * 3;
+    for (int y = 0; y < height; ++y) {
+        std::memcpy(&image.pixels[y * rowBytes], &rows[(height - 1 - y) * rowBytes], rowBytes);
+    }
+    return image;
+}
+
+bool loadImage(const std::filesystem::path& path, Image& image) {
+    int channels = 0;
+    unsigned char* data = stbi_load(path.string().c_str(), &image.width, &image.height, &channels, 3);
+    if (!data) return false;
+    image.pixels.assign(data, data + static_cast<size_t>(image.width) * image.height * 3);
+    stbi_image_free(data);
+    return true;
+}
+
+bool writeImage(const std::filesystem::path& path, const Image& image) {
+    return stbi_write_png(path.string().c_str(), image.width, image.height, 3, image.pixels.data(), image.width * 3) != 0;
+}
+
+// Infinite for identical images
+double psnr(const Image& a, const Image& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.pixels.size(); ++i) {
+        double d = static_cast<double>(a.pixels[i]) - static_cast<double>(b.pixels[i]);
+        sum += d * d;
+    }
+    double mse = sum / static_cast<double>(a.pixels.size());
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : std::numeric_limits<double>::infinity();
+}
+
+std::vector<float> luma(const Image& image) {
+    std::vector<float> result(static_cast<size_t>(image.width) * image.height);
+    for (size_t i = 0; i < result.size(); ++i) {
+        const unsigned char* p = &image.pixels[i * 3];
+        result[i] = 0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2];
+    }
+    return result;
+}
+
+// Mean structural similarity over 8x8 windows every 4 pixels; 1 for identical images
+double ssim(const Image& a, const Image& b) {
+    constexpr int Window = 8, Step = 4;
+    constexpr double C1 = (0.01 * 255.0) * (0.01 * 255.0), C2 = (0.03 * 255.0) * (0.03 * 255.0);
+    std::vector<float> la = luma(a), lb = luma(b);
+    double total = 0.0;
+    int windows = 0;
+    for (int y = 0; y + Window <= a.height; y += Step) {
+        for (int x = 0; x + Window <= a.width; x += Step) {
+            double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+            for (int wy = 0; wy < Window; ++wy) {
+                for (int wx = 0; wx < Window; ++wx) {
+                    size_t i = static_cast<size_t>(y + wy) * a.width + (x + wx);
+                    sumA += la[i];
+                    sumB += lb[i];
+                    sumAA += la[i] * la[i];
+                    sumBB += lb[i] * lb[i];
+                    sumAB += la[i] * lb[i];
+                }
+            }
+            constexpr double n = Window * Window;
+            double meanA = sumA / n, meanB = sumB / n;
+            double varA = sumAA / n - meanA * meanA, varB = sumBB / n - meanB * meanB;
+            double covariance = sumAB / n - meanA * meanB;
+            total += ((2.0 * meanA * meanB + C1) * (2.0 * covariance + C2))
+                / ((meanA * meanA + meanB * meanB + C1) * (varA + varB + C2));
+            ++windows;
+        }
+    }
+    return windows > 0 ? total / windows : 1.0;
+}
+
+// The reference dimmed to a quarter, with the largest channel difference of each pixel in red (x8)
+Image diffImage(const Image& reference, const Image& actual) {
+    Image diff = reference;
+    for (size_t i = 0; i < diff.pixels.size(); i += 3) {
+        int largest = 0;
+        for (int c = 0; c < 3; ++c) {
+            largest = std::max(largest, std::abs(static_cast<int>(reference.pixels[i + c]) - static_cast<int>(actual.pixels[i + c])));
+        }
+        unsigned char dimmed = static_cast<unsigned char>((reference.pixels[i] + reference.pixels[i + 1] + reference.pixels[i + 2]) / 12);
+        diff.pixels[i] = static_cast<unsigned char>(std::min(255, dimmed + largest * 8));
+        diff.pixels[i + 1] = dimmed;
+        diff.pixels[i + 2] = dimmed;
+    }
+    return diff;
+}
+
+}
+
+int RunGoldenImages(const GoldenOptions& options, const std::filesystem::path& modelPath,
+    const std::filesystem::path& assetRoot, std::chrono::steady_clock::time_point startTime) {
+    HeadlessContext context;
+    if (!context.Create(options.width, options.height)) {
+        return -1;
+    }
+
+    JobSystem jobs;
+    AssetManager assets;
+    bool bakedTextures = HasGLExtension("GL_EXT_texture_compression_s3tc");
+    AssetFuture<ModelData> modelFuture = assets.Submit<ModelData>(AssetPriority::Normal, [modelPath, &jobs, bakedTextures] {
+        return ModelLoader::Import(modelPath.string(), jobs, bakedTextures);
+        });
+
+    // Full resolution and no HUD, the picture may only depend on the scenario
+    Renderer renderer(assetRoot, assets, modelFuture, jobs, startTime);
+    renderer.SetOutputFramebuffer(context.GetFramebuffer());
+    if (!RenderUntilLoaded(renderer, jobs, options.width, options.height, options.loadTimeoutSeconds, startTime)) {
+        return -1;
+    }
+    const ModelData& modelData = *modelFuture.get();
+
+    std::error_code error;
+    std::filesystem::create_directories(options.update ? options.referenceDirectory : options.outputDirectory, error);
+    int failures = 0;
+    for (const Scenario& scenario : Scenarios) {
+        Simulation simulation(jobs);
+        simulation.SetModel(modelData.nodes, modelData.meshes.size(), modelData.bulbPositions);
+        FrameSnapshot frame;
+        for (int tick = 0; tick < scenario.ticks; ++tick) {
+            simulation.Tick(scenario.input(tick), frame);
+        }
+        renderer.RenderFrame(frame, options.width, options.height);
+        glFinish();
+        Image actual = readFramebuffer(context.GetFramebuffer(), options.width, options.height);
+
+        std::string fileName = std::string(scenario.name) + ".png";
+        if (options.update) {
+            std::filesystem::path path = options.referenceDirectory / fileName;
+            if (!writeImage(path, actual)) {
+                std::cerr << "[Golden] Could not write " << path.string() << std::endl;
+                ++failures;
+            }
+            else std::cout << "[Golden] " << scenario.name << ": reference written to " << path.string() << std::endl;
+            continue;
+        }
+
+        writeImage(options.outputDirectory / fileName, actual);
+        Image reference;
+        if (!loadImage(options.referenceDirectory / fileName, reference)) {
+            std::cerr << "[Golden] " << scenario.name << ": no reference in " << options.referenceDirectory.string()
+                << ", create them with --golden-update" << std::endl;
+            ++failures;
+            continue;
+        }
+        if (reference.width != actual.width || reference.height != actual.height) {
+            std::cerr << "[Golden] " << scenario.name << ": reference is " << reference.width << "x" << reference.height
+                << ", rendered " << actual.width << "x" << actual.height << " (see --golden-size)" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        double scenarioPsnr = psnr(reference, actual), scenarioSsim = ssim(reference, actual);
+        bool passed = scenarioPsnr >= scenario.minPsnr && scenarioSsim >= scenario.minSsim;
+        std::cout << "[Golden] " << scenario.name << ": PSNR " << scenarioPsnr << " dB (min " << scenario.minPsnr << "), SSIM "
+            << scenarioSsim << " (min " << scenario.minSsim << ") " << (passed ? "passed" : "FAILED") << std::endl;
+        if (!passed) {
+            std::filesystem::path diffPath = options.outputDirectory / (std::string(scenario.name) + "_diff.png");
+            writeImage(diffPath, diffImage(reference, actual));
+            std::cout << "[Golden] Differences written to " << diffPath.string() << std::endl;
+            ++failures;
+        }
+    }
+
+    int scenarioCount = static_cast<int>(sizeof(Scenarios) / sizeof(Scenarios[0]));
+    if (options.update) {
+        std::cout << "[Golden] " << scenarioCount - failures << " of " << scenarioCount << " references written" << std::endl;
+    }
+    else {
+        std::cout << "[Golden] " << scenarioCount - failures << " of " << scenarioCount << " scenarios passed, frames in "
+            << options.outputDirectory.string() << std::endl;
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+#ifndef GOLDEN_IMAGES_H
+#define GOLDEN_IMAGES_H
+
+#include <chrono>
+#include <filesystem>
+
+struct GoldenOptions {
+    std::filesystem::path referenceDirectory = "golden"; // <scenario>.png per scenario
+    std::filesystem::path outputDirectory = "golden_out"; // rendered frames and diff images
+    int width = 640, height = 360;
+    bool update = false; // write the references instead of comparing against them
+    double loadTimeoutSeconds = 120.0;
+};
+
+// Reads --golden [reference dir], --golden-update, --golden-out <dir> and --golden-size WxH.
+// Returns true when --golden or --golden-update was given.
+bool ParseGoldenOptions(int argc, char** argv, GoldenOptions& options);
+
+// Headless regression check for changes that must not alter the picture. Every scenario starts
+// a fresh simulation, drives it for a fixed number of ticks with scripted input, renders that one
+// frame at full resolution and compares it with the stored reference by PSNR (RGB) and SSIM
+// (luma, 8x8 windows), each against the scenario's own tolerance. Every rendered frame is
+// written to the output directory, plus a diff image for each failure. References depend on the
+// rasterizer; they are made with --golden-update under Mesa's llvmpipe so any GPU-less machine
+// reproduces them. Returns the process exit code: 0 when every scenario passes.
+int RunGoldenImages(const GoldenOptions& options, const std::filesystem::path& modelPath,
+    const std::filesystem::path& assetRoot, std::chrono::steady_clock::time_point startTime);
+
+#endif
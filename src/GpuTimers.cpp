@@ -0,0 +1,116 @@
+#include "GpuTimers.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+GpuTimers::~GpuTimers() {
+    for (Pass& pass : passes) {
+        glDeleteQueries(FramesInFlight, pass.queries);
+    }
+}
+
+int GpuTimers::AddPass(const char* name) {
+    Pass pass;
+    pass.name = name;
+    glGenQueries(FramesInFlight, pass.queries);
+    passes.push_back(pass);
+    return static_cast<int>(passes.size()) - 1;
+}
+
+void GpuTimers::BeginFrame() {
+    slot = (slot + 1) % FramesInFlight;
+    lastFrameMs = 0.0;
+    lastFrameComplete = true;
+
+    // The slot about to be reused was issued FramesInFlight frames ago, usually long finished
+    for (Pass& pass : passes) {
+        if (!pass.pending[slot]) continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(pass.queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            lastFrameComplete = false;
+            continue; // Begin() skips this pass for the frame
+        }
+
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(pass.queries[slot], GL_QUERY_RESULT, &elapsed);
+        pass.pending[slot] = false;
+
+        double ms = elapsed / 1.0e6;
+        lastFrameMs += ms;
+        pass.windowSum += ms - (pass.windowCount == AverageWindow ? pass.window[pass.windowNext] : 0.0);
+        pass.window[pass.windowNext] = ms;
+        pass.windowNext = (pass.windowNext + 1) % AverageWindow;
+        pass.windowCount = std::min(pass.windowCount + 1, AverageWindow);
+        pass.totalMs += ms;
+        pass.maxMs = std::max(pass.maxMs, ms);
+        ++pass.samples;
+    }
+}
+
+void GpuTimers::Begin(int pass) {
+    Pass& timed = passes[pass];
+    if (timed.pending[slot]) {
+        ++timed.skipped;
+        return;
+    }
+    glBeginQuery(GL_TIME_ELAPSED, timed.queries[slot]);
+    timed.pending[slot] = true;
+    activePass = pass;
+}
+
+void GpuTimers::End() {
+    if (activePass < 0) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    activePass = -1;
+}
+
+double GpuTimers::GetAverageMs(int pass) const {
+    const Pass& timed = passes[pass];
+    return timed.windowCount ? timed.windowSum / timed.windowCount : 0.0;
+}
+
+double GpuTimers::GetAverageTotalMs() const {
+    double total = 0.0;
+    for (int pass = 0; pass < GetPassCount(); ++pass) {
+        total += GetAverageMs(pass);
+    }
+    return total;
+}
+
+std::string GpuTimers::FormatSummary() const {
+    std::ostringstream summary;
+    summary << std::fixed << std::setprecision(2);
+    for (int pass = 0; pass < GetPassCount(); ++pass) {
+        summary << passes[pass].name << " " << GetAverageMs(pass) << " ms | ";
+    }
+    summary << "total " << GetAverageTotalMs() << " ms";
+    return summary.str();
+}
+
+void GpuTimers::WriteJson(std::ostream& out, const std::string& indent) const {
+    out << "{\n";
+    for (int pass = 0; pass < GetPassCount(); ++pass) {
+        const Pass& timed = passes[pass];
+        out << indent << "  \"" << timed.name << "\": { \"averageMs\": " << GetAverageMs(pass)
+            << ", \"meanMs\": " << (timed.samples ? timed.totalMs / timed.samples : 0.0) << ", \"maxMs\": " << timed.maxMs
+            << ", \"samples\": " << timed.samples << ", \"skipped\": " << timed.skipped << " }"
+            << (pass + 1 < GetPassCount() ? ",\n" : "\n");
+    }
+    out << indent << "}";
+}
+
+bool GpuTimers::WriteJson(const std::filesystem::path& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "[GPU] Could not write " << path.string() << std::endl;
+        return false;
+    }
+    WriteJson(file);
+    file << "\n";
+    std::cout << "[GPU] Pass timings written to " << path.string() << std::endl;
+    return true;
+}
@@ -0,0 +1,78 @@
+#ifndef GPU_TIMERS_H
+#define GPU_TIMERS_H
+
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+
+// GL_TIME_ELAPSED queries around the render passes. Every pass has one query per frame in flight;
+// BeginFrame() reads back the slot issued FramesInFlight frames ago and only if the GPU reports it
+// available, so the CPU never waits for a result. A pass whose old query is still pending skips
+// its measurement for that frame instead. GL_TIME_ELAPSED queries cannot nest, passes must not
+// overlap. Must only be used on the thread that holds the GL context.
+class GpuTimers {
+public:
+    static constexpr int FramesInFlight = 3;
+    static constexpr int AverageWindow = 120; // frames in the rolling average
+
+    GpuTimers() = default;
+    ~GpuTimers();
+    GpuTimers(const GpuTimers&) = delete;
+    GpuTimers& operator=(const GpuTimers&) = delete;
+
+    // Returns the id used with Begin()/Scope
+    int AddPass(const char* name);
+
+    // Call once at the start of every frame, before the first Begin()
+    void BeginFrame();
+    void Begin(int pass);
+    void End();
+
+    class Scope {
+    public:
+        Scope(GpuTimers& timers, int pass) : timers(timers) { timers.Begin(pass); }
+        ~Scope() { timers.End(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        GpuTimers& timers;
+    };
+
+    int GetPassCount() const { return static_cast<int>(passes.size()); }
+    const char* GetPassName(int pass) const { return passes[pass].name; }
+    // Rolling averages over the last AverageWindow measured frames, in milliseconds
+    double GetAverageMs(int pass) const;
+    double GetAverageTotalMs() const;
+    // Sum of the pass results read back by the latest BeginFrame(), i.e. of a frame a few frames ago
+    double GetLastFrameMs() const { return lastFrameMs; }
+    // Every pass of that frame was read back, GetLastFrameMs() is not missing one still in flight
+    bool IsLastFrameComplete() const { return lastFrameComplete; }
+
+    // "opaque 0.41 ms | sky 0.05 ms | ... | total 1.20 ms"
+    std::string FormatSummary() const;
+    // {"passName": {"averageMs", "meanMs", "maxMs", "samples"}, ...} for the whole run
+    void WriteJson(std::ostream& out, const std::string& indent = "") const;
+    bool WriteJson(const std::filesystem::path& path) const;
+
+private:
+    struct Pass {
+        const char* name;
+        GLuint queries[FramesInFlight] = {};
+        bool pending[FramesInFlight] = {};
+        double window[AverageWindow] = {};
+        int windowCount = 0, windowNext = 0;
+        double windowSum = 0.0;
+        double totalMs = 0.0, maxMs = 0.0;
+        unsigned long long samples = 0, skipped = 0;
+    };
+
+    std::vector<Pass> passes;
+    int slot = 0;
+    int activePass = -1;
+    double lastFrameMs = 0.0;
+    bool lastFrameComplete = false;
+};
+
+#endif
@@ -0,0 +1,216 @@
+#include "HeadlessContext.h"
+#include <cstdint>
+#include <iostream>
+#include "GLExtensions.h"
+#if defined(__linux__)
+#include <dlfcn.h>
+#endif
+
+// ----- Surfaceless EGL ----- //
+// Loaded at runtime like GLFW does, so the build needs neither EGL headers nor libEGL.
+
+#if defined(__linux__)
+namespace {
+typedef int32_t EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+
+constexpr EGLint EGL_NONE = 0x3038;
+constexpr EGLint EGL_SURFACE_TYPE = 0x3033;
+constexpr EGLint EGL_PBUFFER_BIT = 0x0001;
+constexpr EGLint EGL_RENDERABLE_TYPE = 0x3040;
+constexpr EGLint EGL_OPENGL_BIT = 0x0008;
+constexpr EGLenum EGL_OPENGL_API = 0x30A2;
+constexpr EGLint EGL_CONTEXT_MAJOR_VERSION = 0x3098;
+constexpr EGLint EGL_CONTEXT_MINOR_VERSION = 0x30FB;
+constexpr EGLint EGL_CONTEXT_OPENGL_PROFILE_MASK = 0x30FD;
+constexpr EGLint EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT = 0x0001;
+constexpr EGLenum EGL_PLATFORM_SURFACELESS_MESA = 0x31DD;
+
+typedef void* (*PFN_eglGetProcAddress)(const char*);
+typedef EGLDisplay (*PFN_eglGetDisplay)(void*);
+typedef EGLDisplay (*PFN_eglGetPlatformDisplayEXT)(EGLenum, void*, const EGLint*);
+typedef EGLBoolean (*PFN_eglInitialize)(EGLDisplay, EGLint*, EGLint*);
+typedef EGLBoolean (*PFN_eglTerminate)(EGLDisplay);
+typedef EGLBoolean (*PFN_eglChooseConfig)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+typedef EGLBoolean (*PFN_eglBindAPI)(EGLenum);
+typedef EGLContext (*PFN_eglCreateContext)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+typedef EGLBoolean (*PFN_eglDestroyContext)(EGLDisplay, EGLContext);
+typedef EGLBoolean (*PFN_eglMakeCurrent)(EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+
+PFN_eglGetProcAddress eglGetProcAddress = nullptr;
+
+void* loadEGLProc(const char* name) {
+    return eglGetProcAddress(name);
+}
+}
+#endif
+
+HeadlessContext::~HeadlessContext() {
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        glDeleteRenderbuffers(1, &colorBuffer);
+        glDeleteRenderbuffers(1, &depthBuffer);
+    }
+    releaseEGL();
+    if (window) {
+        glfwDestroyWindow(window);
+    }
+    if (glfwInitialized) {
+        glfwTerminate();
+    }
+}
+
+bool HeadlessContext::Create(int width, int height) {
+    bool created = createEGL() || createGLFW(GLFW_ANY_PLATFORM) || createGLFW(GLFW_PLATFORM_NULL);
+    if (!created) {
+        std::cerr << "[Benchmark] Could not create an offscreen OpenGL 3.3 context" << std::endl;
+        return false;
+    }
+
+    createFramebuffer(width, height);
+    std::cout << "[Benchmark] " << backend << " context: " << glGetString(GL_RENDERER) << ", " << glGetString(GL_VERSION) << std::endl;
+    return true;
+}
+
+void HeadlessContext::releaseEGL() {
+#if defined(__linux__)
+    if (eglContext) {
+        auto makeCurrent = reinterpret_cast<PFN_eglMakeCurrent>(dlsym(eglLibrary, "eglMakeCurrent"));
+        auto destroyContext = reinterpret_cast<PFN_eglDestroyContext>(dlsym(eglLibrary, "eglDestroyContext"));
+        makeCurrent(eglDisplay, nullptr, nullptr, nullptr);
+        destroyContext(eglDisplay, eglContext);
+        eglContext = nullptr;
+    }
+    if (eglDisplay) {
+        reinterpret_cast<PFN_eglTerminate>(dlsym(eglLibrary, "eglTerminate"))(eglDisplay);
+        eglDisplay = nullptr;
+    }
+    if (eglLibrary) {
+        dlclose(eglLibrary);
+        eglLibrary = nullptr;
+    }
+#endif
+}
+
+// A failed attempt leaves nothing behind for the GLFW fallbacks
+bool HeadlessContext::createEGL() {
+    if (initializeEGL()) return true;
+    releaseEGL();
+    return false;
+}
+
+bool HeadlessContext::initializeEGL() {
+#if defined(__linux__)
+    eglLibrary = dlopen("libEGL.so.1", RTLD_LAZY | RTLD_LOCAL);
+    if (!eglLibrary) return false;
+
+    eglGetProcAddress = reinterpret_cast<PFN_eglGetProcAddress>(dlsym(eglLibrary, "eglGetProcAddress"));
+    auto getDisplay = reinterpret_cast<PFN_eglGetDisplay>(dlsym(eglLibrary, "eglGetDisplay"));
+    auto initialize = reinterpret_cast<PFN_eglInitialize>(dlsym(eglLibrary, "eglInitialize"));
+    auto chooseConfig = reinterpret_cast<PFN_eglChooseConfig>(dlsym(eglLibrary, "eglChooseConfig"));
+    auto bindAPI = reinterpret_cast<PFN_eglBindAPI>(dlsym(eglLibrary, "eglBindAPI"));
+    auto createContext = reinterpret_cast<PFN_eglCreateContext>(dlsym(eglLibrary, "eglCreateContext"));
+    auto makeCurrent = reinterpret_cast<PFN_eglMakeCurrent>(dlsym(eglLibrary, "eglMakeCurrent"));
+    if (!eglGetProcAddress || !getDisplay || !initialize || !chooseConfig || !bindAPI || !createContext || !makeCurrent) {
+        return false;
+    }
+
+    // Mesa's surfaceless platform first, then whatever the default display is
+    auto getPlatformDisplay = reinterpret_cast<PFN_eglGetPlatformDisplayEXT>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) {
+        eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+    }
+    if (!eglDisplay) {
+        eglDisplay = getDisplay(nullptr);
+    }
+    if (!eglDisplay || !initialize(eglDisplay, nullptr, nullptr)) {
+        eglDisplay = nullptr;
+        return false;
+    }
+
+    const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!chooseConfig(eglDisplay, configAttribs, &config, 1, &configCount) || configCount == 0 || !bindAPI(EGL_OPENGL_API)) {
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE };
+    eglContext = createContext(eglDisplay, config, nullptr, contextAttribs);
+    // No surface at all (EGL_KHR_surfaceless_context), rendering goes to our framebuffer
+    if (!eglContext || !makeCurrent(eglDisplay, nullptr, nullptr, eglContext)) {
+        return false;
+    }
+    if (!LoadGLFunctions(loadEGLProc)) {
+        return false;
+    }
+
+    backend = "Surfaceless EGL";
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool HeadlessContext::createGLFW(int platform) {
+    if (platform != GLFW_ANY_PLATFORM && !glfwPlatformSupported(platform)) {
+        return false;
+    }
+    if (glfwInitialized) {
+        glfwTerminate();
+        glfwInitialized = false;
+    }
+
+    glfwInitHint(GLFW_PLATFORM, platform);
+    if (!glfwInit()) return false;
+    glfwInitialized = true;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    window = glfwCreateWindow(64, 64, "Carousel Viewer Benchmark", NULL, NULL);
+    if (!window) return false;
+
+    glfwMakeContextCurrent(window);
+    glfwSwapInterval(0); // never wait for vsync
+    if (!LoadGLFunctions((GLProcLoader)glfwGetProcAddress)) {
+        return false;
+    }
+
+    backend = platform == GLFW_PLATFORM_NULL ? "GLFW null platform (OSMesa)" : "Hidden GLFW window";
+    return true;
+}
+
+void HeadlessContext::createFramebuffer(int width, int height) {
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    std::string size = std::to_string(width) + "x" + std::to_string(height);
+    colorMemory = TrackedMemory(MemoryCategory::RenderTargets, "headless output", "color, " + size, MemoryTracker::FormatName(GL_RGBA8),
+        MemoryTracker::TextureLevelBytes(GL_RGBA8, width, height));
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    depthMemory = TrackedMemory(MemoryCategory::RenderTargets, "headless output", "depth, " + size, MemoryTracker::FormatName(GL_DEPTH24_STENCIL8),
+        MemoryTracker::TextureLevelBytes(GL_DEPTH24_STENCIL8, width, height));
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[Benchmark] Offscreen framebuffer is incomplete" << std::endl;
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef HEADLESS_CONTEXT_H
+#define HEADLESS_CONTEXT_H
+
+#include <string>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include "MemoryTracker.h"
+
+// Offscreen GL 3.3 core context for the benchmark, together with the framebuffer it renders to.
+// On Linux a surfaceless EGL context comes first: it needs no display server, and with Mesa's
+// llvmpipe not even a GPU. Otherwise an invisible GLFW window is used. GLFW's null platform is
+// the last resort, it only gets a context through OSMesa. There is never a usable default
+// framebuffer, frames go to GetFramebuffer().
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    // Creates the context, makes it current on the calling thread and loads glad
+    bool Create(int width, int height);
+
+    unsigned int GetFramebuffer() const { return framebuffer; }
+    const std::string& GetBackendName() const { return backend; }
+
+private:
+    bool createEGL();
+    bool initializeEGL();
+    // Destroys the context, terminates the display and unloads libEGL, whatever got that far
+    void releaseEGL();
+    bool createGLFW(int platform);
+    void createFramebuffer(int width, int height);
+
+    std::string backend;
+    GLFWwindow* window = nullptr;
+    bool glfwInitialized = false;
+    void* eglLibrary = nullptr;
+    void* eglDisplay = nullptr;
+    void* eglContext = nullptr;
+    unsigned int framebuffer = 0, colorBuffer = 0, depthBuffer = 0;
+    TrackedMemory colorMemory, depthMemory;
+};
+
+#endif
@@ -0,0 +1,308 @@
+#include "Hud.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdio>
+
+// ----- Glyph atlas ----- //
+// 5x7 font for ASCII 32 (' ') to 95 ('_'), one byte per row with bit 4 as the leftmost pixel.
+// Lowercase is drawn as uppercase. One extra solid cell after the font backs the panel.
+
+namespace {
+constexpr int FirstGlyph = 32;
+constexpr int FontGlyphCount = 64;
+constexpr int SolidGlyph = FontGlyphCount;
+constexpr int GlyphWidth = 5, GlyphHeight = 7;
+constexpr int CellWidth = 6, CellHeight = 8; // glyph plus one pixel of spacing
+constexpr int AtlasColumns = 16, AtlasRows = 5;
+
+constexpr unsigned char Font[FontGlyphCount][GlyphHeight] = {
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, // ' '
+    { 0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04 }, // '!'
+    { 0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00 }, // '"'
+    { 0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A }, // '#'
+    { 0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04 }, // '$'
+    { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 }, // '%'
+    { 0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D }, // '&'
+    { 0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00 }, // '''
+    { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 }, // '('
+    { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 }, // ')'
+    { 0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00 }, // '*'
+    { 0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00 }, // '+'
+    { 0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08 }, // ','
+    { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 }, // '-'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C }, // '.'
+    { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 }, // '/'
+    { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E }, // '0'
+    { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E }, // '1'
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F }, // '2'
+    { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E }, // '3'
+    { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 }, // '4'
+    { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E }, // '5'
+    { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E }, // '6'
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 }, // '7'
+    { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E }, // '8'
+    { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C }, // '9'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 }, // ':'
+    { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08 }, // ';'
+    { 0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02 }, // '<'
+    { 0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00 }, // '='
+    { 0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08 }, // '>'
+    { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04 }, // '?'
+    { 0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E }, // '@'
+    { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 }, // 'A'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E }, // 'B'
+    { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E }, // 'C'
+    { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C }, // 'D'
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F }, // 'E'
+    { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 }, // 'F'
+    { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F }, // 'G'
+    { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 }, // 'H'
+    { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E }, // 'I'
+    { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C }, // 'J'
+    { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, // 'K'
+    { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F }, // 'L'
+    { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 }, // 'M'
+    { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 }, // 'N'
+    { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'O'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 }, // 'P'
+    { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D }, // 'Q'
+    { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 }, // 'R'
+    { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E }, // 'S'
+    { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 }, // 'T'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E }, // 'U'
+    { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 }, // 'V'
+    { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A }, // 'W'
+    { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 }, // 'X'
+    { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 }, // 'Y'
+    { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F }, // 'Z'
+    { 0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E }, // '['
+    { 0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00 }, // '\'
+    { 0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E }, // ']'
+    { 0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00 }, // '^'
+    { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F }, // '_'
+};
+
+constexpr uint8_t PanelColor[4] = { 0, 0, 0, 160 };
+constexpr uint8_t TextColor[4] = { 220, 220, 220, 255 };
+constexpr uint8_t GoodColor[4] = { 120, 230, 120, 255 };
+constexpr uint8_t SlowColor[4] = { 240, 200, 90, 255 };
+constexpr uint8_t BadColor[4] = { 240, 90, 80, 255 };
+
+int glyphIndex(char c) {
+    int code = std::toupper(static_cast<unsigned char>(c));
+    return code >= FirstGlyph && code < FirstGlyph + FontGlyphCount ? code - FirstGlyph : '?' - FirstGlyph;
+}
+
+// "1234 MS", or "--" for a milestone not reached yet
+void formatMilestone(char* out, size_t size, double ms) {
+    if (ms < 0.0) std::snprintf(out, size, "--");
+    else std::snprintf(out, size, "%.0f MS", ms);
+}
+
+double millisecondsBetween(std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+}
+
+Hud::Hud() {
+    // ----- Bake the atlas ----- //
+    std::vector<unsigned char> pixels(AtlasColumns * CellWidth * AtlasRows * CellHeight, 0);
+    int pitch = AtlasColumns * CellWidth;
+    for (int glyph = 0; glyph <= SolidGlyph; ++glyph) {
+        int originX = (glyph % AtlasColumns) * CellWidth;
+        int originY = (glyph / AtlasColumns) * CellHeight;
+        for (int y = 0; y < CellHeight; ++y) {
+            for (int x = 0; x < CellWidth; ++x) {
+                bool set = glyph == SolidGlyph ||
+                    (x < GlyphWidth && y < GlyphHeight && (Font[glyph][y] >> (GlyphWidth - 1 - x)) & 1);
+                pixels[(originY + y) * pitch + originX + x] = set ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, pitch, AtlasRows * CellHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    atlasMemory = TrackedMemory(MemoryCategory::Textures, "hud", "glyph atlas", MemoryTracker::FormatName(GL_R8),
+        MemoryTracker::TextureLevelBytes(GL_R8, pitch, AtlasRows * CellHeight));
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // ----- Per-glyph instance attributes, no vertex buffer: the quad comes from gl_VertexID ----- //
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &instanceBuffer);
+    instanceMemory = TrackedMemory(MemoryCategory::Staging, "hud", "glyph instances", "instance " + std::to_string(sizeof(GlyphInstance)) + " B", 0);
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(GlyphInstance), (void*)offsetof(GlyphInstance, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribDivisor(0, 1);
+    glVertexAttribPointer(1, 1, GL_UNSIGNED_SHORT, GL_FALSE, sizeof(GlyphInstance), (void*)offsetof(GlyphInstance, glyph));
+    glEnableVertexAttribArray(1);
+    glVertexAttribDivisor(1, 1);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(GlyphInstance), (void*)offsetof(GlyphInstance, color));
+    glEnableVertexAttribArray(2);
+    glVertexAttribDivisor(2, 1);
+
+    glBindVertexArray(0);
+}
+
+Hud::~Hud() {
+    glDeleteTextures(1, &atlasTexture);
+    glDeleteBuffers(1, &instanceBuffer);
+    glDeleteVertexArrays(1, &vao);
+}
+
+void Hud::RecordFrame() {
+    auto now = std::chrono::steady_clock::now();
+    if (lastFrame != std::chrono::steady_clock::time_point()) {
+        double ms = millisecondsBetween(lastFrame, now);
+        frameSumMs += ms;
+        frameMaxMs = std::max(frameMaxMs, ms);
+        ++frameCount;
+    }
+    lastFrame = now;
+}
+
+float Hud::addText(float x, float y, const char* text, int scale, const uint8_t color[4]) {
+    float startX = x;
+    for (const char* c = text; *c; ++c) {
+        if (*c != ' ') {
+            GlyphInstance glyph = { x, y, static_cast<float>(CellWidth * scale), static_cast<float>(CellHeight * scale),
+                static_cast<uint16_t>(glyphIndex(*c)), 0, { color[0], color[1], color[2], color[3] } };
+            instances.push_back(glyph);
+        }
+        x += CellWidth * scale;
+    }
+    return x - startX;
+}
+
+void Hud::rebuild(const HudValues& values, int scale) {
+    instances.clear();
+    instances.push_back(GlyphInstance()); // panel, sized once the text is laid out
+
+    float padding = 4.0f * scale;
+    float lineHeight = (CellHeight + 2.0f) * scale;
+    float x = padding * 2.0f, y = padding * 2.0f;
+    float width = 0.0f;
+    char line[128];
+
+    // Frame time in the color of the refresh budget it fits
+    const uint8_t* frameColor = shownFrameMs <= 17.0 ? GoodColor : shownFrameMs <= 34.0 ? SlowColor : BadColor;
+    std::snprintf(line, sizeof(line), "FRAME %6.2f MS  %5.1f FPS  MAX %6.2f MS", shownFrameMs,
+        shownFrameMs > 0.0 ? 1000.0 / shownFrameMs : 0.0, shownFrameMaxMs);
+    width = std::max(width, addText(x, y, line, scale, frameColor));
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "GPU   %6.2f MS", values.gpuMs);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    // The post chain in the slow color once it no longer fits its budget
+    std::snprintf(line, sizeof(line), "POST  %6.2f MS  BUDGET %.2f MS", values.postGpuMs, values.postBudgetMs);
+    width = std::max(width, addText(x, y, line, scale, values.postGpuMs <= values.postBudgetMs ? TextColor : SlowColor));
+    y += lineHeight;
+
+    // Dynamic resolution in the slow color while it renders below full resolution
+    if (values.frameTargetMs > 0.0) {
+        std::snprintf(line, sizeof(line), "SCALE %4.2f  %dX%d  TARGET %.2f MS", values.renderScale, values.renderWidth,
+            values.renderHeight, values.frameTargetMs);
+    }
+    else {
+        std::snprintf(line, sizeof(line), "SCALE %4.2f  %dX%d", values.renderScale, values.renderWidth, values.renderHeight);
+    }
+    width = std::max(width, addText(x, y, line, scale, values.renderScale < 1.0f ? SlowColor : TextColor));
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "MEM   GPU %.1f MB  CPU %.1f MB", values.gpuMemoryBytes / (1024.0 * 1024.0),
+        values.cpuMemoryBytes / (1024.0 * 1024.0));
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    if (values.capturedFrames > 0) {
+        std::snprintf(line, sizeof(line), "CAPT  %llu  DROPPED %llu  CPU %.2f MS  GPU %.2f MS",
+            static_cast<unsigned long long>(values.capturedFrames), static_cast<unsigned long long>(values.droppedFrames),
+            values.captureCpuMs, values.captureGpuMs);
+        width = std::max(width, addText(x, y, line, scale, values.droppedFrames > 0 ? SlowColor : TextColor));
+        y += lineHeight;
+    }
+
+    std::snprintf(line, sizeof(line), "DRAWS %d  TRIS %zu  CULLED %zu", values.drawCalls, values.triangles, values.culledMeshes);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "GL    %d ISSUED  %d ELIDED", values.glIssued, values.glElided);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "BULBS %d", values.bulbs);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    char first[24], environment[24], carousel[24];
+    formatMilestone(first, sizeof(first), values.firstFrameMs);
+    formatMilestone(environment, sizeof(environment), values.environmentMs);
+    formatMilestone(carousel, sizeof(carousel), values.carouselMs);
+    std::snprintf(line, sizeof(line), "LOAD  FIRST %s  SCENE %s  CAROUSEL %s", first, environment, carousel);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "HUD   CPU %.3f MS  GPU %.3f MS", shownCpuMs, values.hudGpuMs);
+    width = std::max(width, addText(x, y, line, scale, TextColor));
+    y += lineHeight;
+
+    instances[0] = { padding, padding, width + padding * 2.0f, y - padding,
+        static_cast<uint16_t>(SolidGlyph), 0, { PanelColor[0], PanelColor[1], PanelColor[2], PanelColor[3] } };
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    if (instances.size() > instanceCapacity) {
+        instanceCapacity = instances.size() * 2;
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity * sizeof(GlyphInstance), nullptr, GL_DYNAMIC_DRAW);
+        instanceMemory.Resize(instanceCapacity * sizeof(GlyphInstance));
+    }
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(GlyphInstance), instances.data());
+}
+
+void Hud::Draw(GLState& state, unsigned int program, const HudValues& values, int width, int height) {
+    auto start = std::chrono::steady_clock::now();
+
+    // Text only changes a few times a second, the rolling averages cover the frames in between
+    int scale = std::max(2, height / 480);
+    if (instances.empty() || scale != builtScale || start - lastRebuild >= UpdateInterval) {
+        if (frameCount > 0) {
+            shownFrameMs = frameSumMs / frameCount;
+            shownFrameMaxMs = frameMaxMs;
+        }
+        if (drawCount > 0) {
+            shownCpuMs = cpuSumMs / drawCount;
+        }
+        frameSumMs = frameMaxMs = cpuSumMs = 0.0;
+        frameCount = drawCount = 0;
+
+        rebuild(values, scale);
+        builtScale = scale;
+        lastRebuild = start;
+    }
+
+    state.UseProgram(program);
+    state.SetUniform("atlasGrid", glm::vec2(AtlasColumns, AtlasRows));
+    state.SetUniform("glyphAtlas", 0);
+    state.SetUniform("screenSize", glm::vec2(width, height));
+
+    state.SetDepthTest(false);
+    state.SetBlend(true);
+    state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    state.BindTexture(0, GL_TEXTURE_2D, atlasTexture);
+    state.BindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(instances.size()));
+
+    cpuSumMs += millisecondsBetween(start, std::chrono::steady_clock::now());
+    ++drawCount;
+}
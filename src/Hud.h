@@ -0,0 +1,77 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glad/glad.h>
+#include "GLState.h"
+#include "MemoryTracker.h"
+
+// Renderer figures shown by the overlay, next to the timings it measures itself
+struct HudValues {
+    int drawCalls = 0;
+    size_t triangles = 0;
+    size_t culledMeshes = 0;
+    int bulbs = 0;
+    double gpuMs = 0.0;    // rolling average of all GPU passes
+    double hudGpuMs = 0.0; // the overlay's own pass
+    double firstFrameMs = -1.0, environmentMs = -1.0, carouselMs = -1.0;
+    int glIssued = 0, glElided = 0; // state changes and uniforms of the last frame, see GLState
+    double postGpuMs = 0.0, postBudgetMs = 0.0; // bloom and tonemap, see PostProcess
+    float renderScale = 1.0f;
+    int renderWidth = 0, renderHeight = 0;
+    double frameTargetMs = 0.0; // dynamic resolution target, 0 when the scale is fixed
+    uint64_t capturedFrames = 0, droppedFrames = 0; // see FrameCapture, the line shows after the first capture
+    double captureCpuMs = 0.0, captureGpuMs = 0.0;
+    size_t gpuMemoryBytes = 0, cpuMemoryBytes = 0; // see MemoryTracker
+};
+
+// Performance overlay in the top-left corner. The 5x7 font is compiled in and baked into a
+// single-channel glyph atlas at startup; every character (and the backdrop) is one instance of a
+// unit quad, so the whole overlay is one glDrawArraysInstanced. The instance buffer is only
+// rebuilt when the text changes, every UpdateInterval, so a visible HUD costs one bind-and-draw
+// per frame. Must only be used on the thread that holds the GL context.
+class Hud {
+public:
+    static constexpr std::chrono::milliseconds UpdateInterval{ 250 };
+
+    Hud();
+    ~Hud();
+    Hud(const Hud&) = delete;
+    Hud& operator=(const Hud&) = delete;
+
+    // Call once per rendered frame, visible or not, so the frame time window stays current
+    void RecordFrame();
+    // Draws with the program built from hud.vs/hud.fs, on top of whatever is in the framebuffer
+    void Draw(GLState& state, unsigned int program, const HudValues& values, int width, int height);
+
+private:
+    struct GlyphInstance {
+        float x, y, width, height; // pixels, origin top-left
+        uint16_t glyph;
+        uint16_t padding;
+        uint8_t color[4];
+    };
+
+    void rebuild(const HudValues& values, int scale);
+    // Returns the width of the text in pixels
+    float addText(float x, float y, const char* text, int scale, const uint8_t color[4]);
+
+    unsigned int atlasTexture = 0;
+    unsigned int vao = 0, instanceBuffer = 0;
+    size_t instanceCapacity = 0;
+    TrackedMemory atlasMemory, instanceMemory;
+    std::vector<GlyphInstance> instances;
+    int builtScale = 0;
+
+    // Accumulated since the text was last rebuilt
+    std::chrono::steady_clock::time_point lastFrame, lastRebuild;
+    double frameSumMs = 0.0, frameMaxMs = 0.0, cpuSumMs = 0.0;
+    int frameCount = 0, drawCount = 0;
+    // Shown until the next rebuild
+    double shownFrameMs = 0.0, shownFrameMaxMs = 0.0, shownCpuMs = 0.0;
+};
+
+#endif
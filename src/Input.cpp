@@ -0,0 +1,36 @@
+#include "Input.h"
+
+void InputState::OnKey(int key, int action) {
+    if (key < 0 || key > GLFW_KEY_LAST) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (action == GLFW_PRESS) {
+        pending.down.set(key);
+        pending.pressed.set(key);
+    }
+    else if (action == GLFW_RELEASE) {
+        pending.down.reset(key);
+    }
+}
+
+void InputState::OnCursor(double xpos, double ypos) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (firstMouse) {
+        lastX = xpos;
+        lastY = ypos;
+        firstMouse = false;
+    }
+
+    pending.mouseDelta.x += static_cast<float>(xpos - lastX);
+    pending.mouseDelta.y += static_cast<float>(lastY - ypos); // reversed since y goes from top to bottom
+    lastX = xpos;
+    lastY = ypos;
+}
+
+InputFrame InputState::Sample() {
+    std::lock_guard<std::mutex> lock(mutex);
+    InputFrame frame = pending;
+    pending.pressed.reset();
+    pending.mouseDelta = glm::vec2(0.0f);
+    return frame;
+}
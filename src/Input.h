@@ -0,0 +1,36 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <bitset>
+#include <mutex>
+
+// Input gathered between two simulation ticks
+struct InputFrame {
+    std::bitset<GLFW_KEY_LAST + 1> down;    // keys held at sample time
+    std::bitset<GLFW_KEY_LAST + 1> pressed; // keys that went down since the previous sample
+    glm::vec2 mouseDelta = glm::vec2(0.0f); // accumulated cursor movement (x right, y up)
+
+    bool IsDown(int key) const { return key >= 0 && key <= GLFW_KEY_LAST && down.test(key); }
+    bool WasPressed(int key) const { return key >= 0 && key <= GLFW_KEY_LAST && pressed.test(key); }
+};
+
+// Written by the GLFW callbacks on the main thread, sampled by the simulation thread.
+// Key presses are latched so a tap shorter than one tick is never lost.
+class InputState {
+public:
+    void OnKey(int key, int action);
+    void OnCursor(double xpos, double ypos);
+
+    // Returns everything that happened since the previous call and clears the edges/mouse delta
+    InputFrame Sample();
+
+private:
+    std::mutex mutex;
+    InputFrame pending;
+    double lastX = 0.0, lastY = 0.0;
+    bool firstMouse = true;
+};
+
+#endif
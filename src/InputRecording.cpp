@@ -0,0 +1,155 @@
+#include "InputRecording.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace {
+constexpr char Magic[4] = { 'C', 'I', 'R', '1' };
+// A day at the 60 Hz simulation tick. The tick count is read from the file before anything is
+// allocated for it, a corrupt header must not turn into a multi-gigabyte reservation.
+constexpr uint64_t MaxTicks = 60ull * 60 * 60 * 24;
+
+// Tick flags
+constexpr uint8_t DownChanged = 1 << 0;
+constexpr uint8_t HasPressed = 1 << 1;
+constexpr uint8_t HasMouse = 1 << 2;
+
+void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool readVarint(const std::vector<uint8_t>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+template <size_t N>
+void writeKeys(std::vector<uint8_t>& out, const std::bitset<N>& keys) {
+    writeVarint(out, keys.count());
+    for (size_t key = 0; key < N; ++key) {
+        if (keys.test(key)) writeVarint(out, key);
+    }
+}
+
+template <size_t N>
+bool readKeys(const std::vector<uint8_t>& in, size_t& pos, std::bitset<N>& keys) {
+    uint64_t count, key;
+    if (!readVarint(in, pos, count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        if (!readVarint(in, pos, key) || key >= N) return false;
+        keys.set(key);
+    }
+    return true;
+}
+
+void writeFloat(std::vector<uint8_t>& out, float value) {
+    uint8_t bytes[sizeof(float)];
+    std::memcpy(bytes, &value, sizeof(float));
+    out.insert(out.end(), bytes, bytes + sizeof(float));
+}
+
+bool readFloat(const std::vector<uint8_t>& in, size_t& pos, float& value) {
+    if (pos + sizeof(float) > in.size()) return false;
+    std::memcpy(&value, &in[pos], sizeof(float));
+    pos += sizeof(float);
+    return true;
+}
+}
+
+// Layout: magic, varint tick count, then per tick with input:
+// varint idle ticks before it, flags, [toggled keys], [pressed keys], [mouse x, y]
+bool InputRecording::Save(const std::filesystem::path& path) const {
+    std::vector<uint8_t> out(Magic, Magic + sizeof(Magic));
+    writeVarint(out, frames.size());
+
+    std::bitset<GLFW_KEY_LAST + 1> down;
+    uint64_t idleTicks = 0;
+    for (const InputFrame& frame : frames) {
+        uint8_t flags = (frame.down != down ? DownChanged : 0) | (frame.pressed.any() ? HasPressed : 0) |
+            (frame.mouseDelta != glm::vec2(0.0f) ? HasMouse : 0);
+        if (!flags) {
+            ++idleTicks;
+            continue;
+        }
+
+        writeVarint(out, idleTicks);
+        out.push_back(flags);
+        if (flags & DownChanged) writeKeys(out, frame.down ^ down);
+        if (flags & HasPressed) writeKeys(out, frame.pressed);
+        if (flags & HasMouse) {
+            writeFloat(out, frame.mouseDelta.x);
+            writeFloat(out, frame.mouseDelta.y);
+        }
+        down = frame.down;
+        idleTicks = 0;
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    if (!file) {
+        std::cerr << "Failed to write input recording: " << path.string() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool InputRecording::Load(const std::filesystem::path& path) {
+    frames.clear();
+    std::ifstream file(path, std::ios::binary);
+    std::vector<uint8_t> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    size_t pos = sizeof(Magic);
+    uint64_t tickCount;
+    if (in.size() < sizeof(Magic) || std::memcmp(in.data(), Magic, sizeof(Magic)) != 0 || !readVarint(in, pos, tickCount)) {
+        std::cerr << "Invalid input recording: " << path.string() << std::endl;
+        return false;
+    }
+
+    if (tickCount > MaxTicks) {
+        std::cerr << "Invalid input recording, " << tickCount << " ticks is more than the limit of " << MaxTicks << ": "
+            << path.string() << std::endl;
+        return false;
+    }
+
+    frames.reserve(tickCount);
+    InputFrame idle;
+    bool truncated = false;
+    while (frames.size() < tickCount && pos < in.size()) {
+        truncated = true;
+        uint64_t idleTicks;
+        if (!readVarint(in, pos, idleTicks) || pos >= in.size()) break;
+        frames.insert(frames.end(), std::min<uint64_t>(idleTicks, tickCount - frames.size()), idle);
+
+        uint8_t flags = in[pos++];
+        InputFrame frame;
+        frame.down = idle.down;
+        std::bitset<GLFW_KEY_LAST + 1> toggled;
+        if ((flags & DownChanged) && !readKeys(in, pos, toggled)) break;
+        if ((flags & HasPressed) && !readKeys(in, pos, frame.pressed)) break;
+        if ((flags & HasMouse) && !(readFloat(in, pos, frame.mouseDelta.x) && readFloat(in, pos, frame.mouseDelta.y))) break;
+        frame.down ^= toggled;
+
+        frames.push_back(frame);
+        idle.down = frame.down; // held keys carry over into the idle ticks that follow
+        truncated = false;
+    }
+    // Replaying the rest as idle would quietly drive a different session
+    if (truncated) {
+        std::cerr << "Invalid input recording, truncated after tick " << frames.size() << ": " << path.string() << std::endl;
+        frames.clear();
+        return false;
+    }
+    // Trailing idle ticks are only counted
+    frames.resize(tickCount, idle);
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+#include "Input.h"
+
+// The InputFrame the simulation consumed at every tick, in order. Replaying them through a fresh
+// Simulation reproduces the session tick for tick, independent of frame rate or machine speed.
+// On disk (.cir) only the changes are kept: a run of identical idle ticks is a single varint, and a
+// tick with input stores the keys that toggled, the keys pressed and the mouse delta if any.
+class InputRecording {
+public:
+    void Append(const InputFrame& frame) { frames.push_back(frame); }
+    void Clear() { frames.clear(); }
+
+    size_t GetTickCount() const { return frames.size(); }
+    // Ticks past the end return an idle frame
+    InputFrame GetFrame(size_t tick) const { return tick < frames.size() ? frames[tick] : InputFrame(); }
+
+    bool Save(const std::filesystem::path& path) const;
+    bool Load(const std::filesystem::path& path);
+
+private:
+    std::vector<InputFrame> frames;
+};
+
+#endif
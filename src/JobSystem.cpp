@@ -0,0 +1,182 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+// Identifies the worker the current thread belongs to (-1 for simulation/render/main)
+static thread_local const JobSystem* tlsJobSystem = nullptr;
+static thread_local int tlsWorkerIndex = -1;
+
+JobSystem::JobSystem(unsigned int workerCount) {
+    if (workerCount == 0) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (unsigned int i = 0; i < workerCount; ++i) {
+        workers[i]->thread = std::thread(&JobSystem::workerLoop, this, static_cast<int>(i));
+    }
+
+    utilizationStart = std::chrono::steady_clock::now();
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+int JobSystem::currentWorkerIndex() const {
+    return tlsJobSystem == this ? tlsWorkerIndex : -1;
+}
+
+void JobSystem::Run(std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(Job{ std::move(job), counter });
+}
+
+void JobSystem::Then(JobCounter& dependency, std::function<void()> job, JobCounter* counter) {
+    if (counter) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::unique_lock<std::mutex> lock(dependency.mutex);
+    if (dependency.pending.load(std::memory_order_acquire) == 0) {
+        lock.unlock();
+        push(Job{ std::move(job), counter });
+        return;
+    }
+    dependency.continuations.push_back([this, job = std::move(job), counter]() mutable {
+        push(Job{ std::move(job), counter });
+        });
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    int self = currentWorkerIndex();
+    while (!counter.IsDone()) {
+        if (!runOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+    // The last finish() may still hold the lock, the counter must outlive it
+    std::lock_guard<std::mutex> lock(counter.mutex);
+}
+
+void JobSystem::push(Job job) {
+    int self = currentWorkerIndex();
+    if (workers.empty()) {
+        // No workers to hand off to, run on the submitting thread
+        job.function();
+        finish(job.counter);
+        return;
+    }
+
+    unsigned int target = self >= 0 ? static_cast<unsigned int>(self) : nextQueue++ % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[target]->mutex);
+        workers[target]->jobs.push_back(std::move(job));
+    }
+    queuedJobs.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wake.notify_one();
+}
+
+bool JobSystem::popOrSteal(int self, Job& out) {
+    // Own deque first, newest job (still warm in cache)
+    if (self >= 0) {
+        Worker& own = *workers[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty()) {
+            out = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another worker
+    size_t count = workers.size();
+    size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+    for (size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers[(start + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty()) {
+            out = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::runOne(int self) {
+    Job job;
+    if (!popOrSteal(self, job)) {
+        return false;
+    }
+    job.function();
+    finish(job.counter);
+    return true;
+}
+
+void JobSystem::finish(JobCounter* counter) {
+    if (!counter) return;
+
+    std::vector<std::function<void()>> released;
+    {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            released.swap(counter->continuations);
+        }
+    }
+    for (auto& continuation : released) {
+        continuation();
+    }
+}
+
+void JobSystem::workerLoop(int index) {
+    tlsJobSystem = this;
+    tlsWorkerIndex = index;
+    Profiler::SetThreadName("Job worker");
+    Worker& self = *workers[index];
+
+    while (!stopping) {
+        auto start = std::chrono::steady_clock::now();
+        if (runOne(index)) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            self.busyNanoseconds.fetch_add(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+float JobSystem::SampleUtilization() {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t busy = 0;
+    for (auto& worker : workers) {
+        busy += worker->busyNanoseconds.load(std::memory_order_relaxed);
+    }
+
+    double elapsed = std::chrono::duration<double, std::nano>(now - utilizationStart).count() * workers.size();
+    float utilization = elapsed > 0.0 ? static_cast<float>((busy - utilizationBusyStart) / elapsed) : 0.0f;
+
+    utilizationStart = now;
+    utilizationBusyStart = busy;
+    return utilization;
+}
@@ -0,0 +1,106 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Counts outstanding jobs. Jobs registered with JobSystem::Then() are released once the count
+// drops to zero, which is how one stage of the frame declares a dependency on another.
+class JobCounter {
+public:
+    bool IsDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{ 0 };
+    std::mutex mutex;
+    std::vector<std::function<void()>> continuations;
+};
+
+// Small work-stealing scheduler. Every worker owns a deque: it pushes and pops its own jobs at
+// the back and steals from the front of the other workers' deques when it runs dry. Threads that
+// are not workers (simulation, render) submit round-robin and help out while they Wait().
+class JobSystem {
+public:
+    // workerCount == 0 picks one worker per hardware thread minus the caller
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void Run(std::function<void()> job, JobCounter* counter = nullptr);
+    // Runs job once dependency reaches zero
+    void Then(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+    // Executes queued jobs on the calling thread until counter reaches zero
+    void Wait(JobCounter& counter);
+
+    // Calls body(begin, end) over [0, count) in chunks of grainSize, the caller runs the first chunk
+    template <typename Body>
+    void ParallelFor(size_t count, size_t grainSize, Body&& body);
+
+    unsigned int WorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+    // Fraction of worker time spent running jobs since the previous call (0..1)
+    float SampleUtilization();
+
+private:
+    struct Job {
+        std::function<void()> function;
+        JobCounter* counter = nullptr;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+        std::atomic<uint64_t> busyNanoseconds{ 0 };
+        std::thread thread;
+    };
+
+    void push(Job job);
+    bool popOrSteal(int self, Job& out);
+    bool runOne(int self);
+    void finish(JobCounter* counter);
+    void workerLoop(int index);
+    int currentWorkerIndex() const;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned int> nextQueue{ 0 };
+    std::atomic<int> queuedJobs{ 0 };
+    std::atomic<bool> stopping{ false };
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+
+    std::chrono::steady_clock::time_point utilizationStart;
+    uint64_t utilizationBusyStart = 0;
+};
+
+template <typename Body>
+void JobSystem::ParallelFor(size_t count, size_t grainSize, Body&& body) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    // Not worth a job: small inputs run inline
+    if (count <= grainSize || workers.empty()) {
+        body(size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = grainSize; begin < count; begin += grainSize) {
+        size_t end = std::min(begin + grainSize, count);
+        Run([&body, begin, end] { body(begin, end); }, &counter);
+    }
+    body(size_t(0), grainSize);
+    Wait(counter);
+}
+
+#endif
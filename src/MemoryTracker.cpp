@@ -0,0 +1,219 @@
+#include "MemoryTracker.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <glad/glad.h>
+#include "CompressedTexture.h"
+
+namespace {
+struct Entry {
+    MemoryCategory category;
+    std::string owner, name, format;
+    size_t bytes;
+};
+
+std::mutex registryMutex;
+std::map<uint64_t, Entry> registry; // by registration order
+uint64_t nextId = 1;
+MemoryTotals totals;
+
+// Call with registryMutex held
+void account(MemoryCategory category, size_t removed, size_t added) {
+    size_t index = static_cast<size_t>(category);
+    totals.bytes[index] = totals.bytes[index] - removed + added;
+    totals.peakBytes[index] = std::max(totals.peakBytes[index], totals.bytes[index]);
+    size_t& sum = MemoryTracker::IsGpu(category) ? totals.gpuBytes : totals.cpuBytes;
+    size_t& peak = MemoryTracker::IsGpu(category) ? totals.peakGpuBytes : totals.peakCpuBytes;
+    sum = sum - removed + added;
+    peak = std::max(peak, sum);
+}
+
+std::string megabytes(size_t bytes) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.1f", bytes / (1024.0 * 1024.0));
+    return text;
+}
+
+// Small allocations (the ground quad, the HUD font) would all show as 0.0 MB
+std::string formatBytes(size_t bytes) {
+    char text[32];
+    if (bytes >= 1024 * 1024) std::snprintf(text, sizeof(text), "%.2f MB", bytes / (1024.0 * 1024.0));
+    else if (bytes >= 1024) std::snprintf(text, sizeof(text), "%.1f KB", bytes / 1024.0);
+    else std::snprintf(text, sizeof(text), "%zu B", bytes);
+    return text;
+}
+
+// Short names for the summary line
+const char* shortName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::RenderTargets: return "targets";
+    case MemoryCategory::CpuGeometry: return "geometry";
+    case MemoryCategory::CpuImages: return "images";
+    default: return MemoryTracker::GetCategoryName(category);
+    }
+}
+}
+
+// ----- TrackedMemory ----- //
+
+TrackedMemory::TrackedMemory(MemoryCategory category, std::string owner, std::string name, std::string format, size_t bytes)
+    : bytes(bytes) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    id = nextId++;
+    registry.emplace(id, Entry{ category, std::move(owner), std::move(name), std::move(format), bytes });
+    ++totals.resources[static_cast<size_t>(category)];
+    account(category, 0, bytes);
+}
+
+TrackedMemory::~TrackedMemory() {
+    Release();
+}
+
+TrackedMemory::TrackedMemory(TrackedMemory&& other) noexcept
+    : id(other.id), bytes(other.bytes) {
+    other.id = 0;
+    other.bytes = 0;
+}
+
+TrackedMemory& TrackedMemory::operator=(TrackedMemory&& other) noexcept {
+    if (this != &other) {
+        Release();
+        id = other.id;
+        bytes = other.bytes;
+        other.id = 0;
+        other.bytes = 0;
+    }
+    return *this;
+}
+
+void TrackedMemory::Resize(size_t newBytes) {
+    if (!id || newBytes == bytes) return;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    Entry& entry = registry.at(id);
+    account(entry.category, entry.bytes, newBytes);
+    entry.bytes = newBytes;
+    bytes = newBytes;
+}
+
+void TrackedMemory::Release() {
+    if (!id) return;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto entry = registry.find(id);
+    account(entry->second.category, entry->second.bytes, 0);
+    --totals.resources[static_cast<size_t>(entry->second.category)];
+    registry.erase(entry);
+    id = 0;
+    bytes = 0;
+}
+
+// ----- MemoryTracker ----- //
+
+MemoryTotals MemoryTracker::GetTotals() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    return totals;
+}
+
+const char* MemoryTracker::GetCategoryName(MemoryCategory category) {
+    switch (category) {
+    case MemoryCategory::Textures: return "textures";
+    case MemoryCategory::Geometry: return "geometry";
+    case MemoryCategory::RenderTargets: return "renderTargets";
+    case MemoryCategory::Staging: return "staging";
+    case MemoryCategory::CpuGeometry: return "cpuGeometry";
+    case MemoryCategory::CpuImages: return "cpuImages";
+    default: return "unknown";
+    }
+}
+
+std::string MemoryTracker::FormatSummary() {
+    MemoryTotals current = GetTotals();
+    std::string gpu, cpu;
+    for (size_t i = 0; i < MemoryTotals::CategoryCount; ++i) {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        std::string& parts = IsGpu(category) ? gpu : cpu;
+        parts += (parts.empty() ? "" : " | ") + std::string(shortName(category)) + " " + megabytes(current.bytes[i]);
+    }
+    return "GPU " + megabytes(current.gpuBytes) + " MB (" + gpu + ") | CPU " + megabytes(current.cpuBytes) + " MB (" + cpu + ")";
+}
+
+void MemoryTracker::WriteBreakdown(std::ostream& out) {
+    std::vector<Entry> entries;
+    MemoryTotals current;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& [id, entry] : registry) {
+            entries.push_back(entry);
+        }
+        current = totals;
+    }
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.category != b.category ? a.category < b.category : a.bytes > b.bytes;
+        });
+
+    char line[256];
+    for (size_t i = 0; i < MemoryTotals::CategoryCount; ++i) {
+        MemoryCategory category = static_cast<MemoryCategory>(i);
+        std::snprintf(line, sizeof(line), "%s %s: %s in %zu, peak %s\n", IsGpu(category) ? "GPU" : "CPU", GetCategoryName(category),
+            formatBytes(current.bytes[i]).c_str(), current.resources[i], formatBytes(current.peakBytes[i]).c_str());
+        out << line;
+        for (const Entry& entry : entries) {
+            if (entry.category != category) continue;
+            std::snprintf(line, sizeof(line), "  %12s  %-16s %-28s %s\n", formatBytes(entry.bytes).c_str(), entry.format.c_str(),
+                entry.owner.c_str(), entry.name.c_str());
+            out << line;
+        }
+    }
+    out << "Total: GPU " << formatBytes(current.gpuBytes) << " (peak " << formatBytes(current.peakGpuBytes) << "), CPU "
+        << formatBytes(current.cpuBytes) << " (peak " << formatBytes(current.peakCpuBytes) << ")" << std::endl;
+}
+
+void MemoryTracker::WriteJson(std::ostream& out, const std::string& indent) {
+    MemoryTotals current = GetTotals();
+    out << "{\n" << indent << "  \"gpuBytes\": " << current.gpuBytes << ", \"cpuBytes\": " << current.cpuBytes
+        << ", \"peakGpuBytes\": " << current.peakGpuBytes << ", \"peakCpuBytes\": " << current.peakCpuBytes << ",\n"
+        << indent << "  \"categories\": {\n";
+    for (size_t i = 0; i < MemoryTotals::CategoryCount; ++i) {
+        out << indent << "    \"" << GetCategoryName(static_cast<MemoryCategory>(i)) << "\": { \"bytes\": " << current.bytes[i]
+            << ", \"peakBytes\": " << current.peakBytes[i] << ", \"resources\": " << current.resources[i] << " }"
+            << (i + 1 < MemoryTotals::CategoryCount ? ",\n" : "\n");
+    }
+    out << indent << "  }\n" << indent << "}";
+}
+
+size_t MemoryTracker::TextureLevelBytes(unsigned int internalFormat, int width, int height) {
+    if (CompressedBlockBytes(internalFormat)) {
+        return CompressedLevelSize(internalFormat, width, height);
+    }
+    size_t pixelBytes;
+    switch (internalFormat) {
+    case GL_RED: case GL_R8: pixelBytes = 1; break;
+    case GL_RG: case GL_RG8: pixelBytes = 2; break;
+    case GL_RGBA16F: pixelBytes = 8; break;
+    case GL_RGBA32F: pixelBytes = 16; break;
+    case GL_DEPTH_COMPONENT24: case GL_DEPTH24_STENCIL8: pixelBytes = 4; break;
+    default: pixelBytes = 4; break; // RGB(A)8, sRGB, R11F_G11F_B10F
+    }
+    return static_cast<size_t>(width) * height * pixelBytes;
+}
+
+std::string MemoryTracker::FormatName(unsigned int internalFormat) {
+    switch (internalFormat) {
+    case GL_RED: case GL_R8: return "R8";
+    case GL_RG: case GL_RG8: return "RG8";
+    case GL_RGB: case GL_RGB8: return "RGB8";
+    case GL_RGBA: case GL_RGBA8: return "RGBA8";
+    case GL_SRGB8: return "SRGB8";
+    case GL_RGBA16F: return "RGBA16F";
+    case GL_RGBA32F: return "RGBA32F";
+    case GL_R11F_G11F_B10F: return "R11F_G11F_B10F";
+    case GL_DEPTH_COMPONENT24: return "DEPTH24";
+    case GL_DEPTH24_STENCIL8: return "DEPTH24_STENCIL8";
+    case CompressedFormatBC1: return "BC1";
+    case CompressedFormatBC5: return "BC5";
+    }
+    char text[16];
+    std::snprintf(text, sizeof(text), "0x%04X", internalFormat);
+    return text;
+}
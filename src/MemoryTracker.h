@@ -0,0 +1,79 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// What an allocation holds. The first four live in GPU memory, the rest on the CPU heap.
+enum class MemoryCategory {
+    Textures,      // sampled images: model textures, ground, skybox, HUD font
+    Geometry,      // vertex and index buffers
+    RenderTargets, // framebuffer attachments: HDR scene, bloom chain, depth, headless output
+    Staging,       // upload, readback and per-frame streaming buffers
+    CpuGeometry,   // imported vertices and indices, and the copies the meshes keep
+    CpuImages,     // decoded texture pixels and mips kept by the imported model
+    Count
+};
+
+struct MemoryTotals {
+    static constexpr size_t CategoryCount = static_cast<size_t>(MemoryCategory::Count);
+    std::array<size_t, CategoryCount> bytes = {};
+    std::array<size_t, CategoryCount> resources = {};
+    std::array<size_t, CategoryCount> peakBytes = {};
+    size_t gpuBytes = 0, cpuBytes = 0;
+    size_t peakGpuBytes = 0, peakCpuBytes = 0; // of the sums, not of the categories added up
+
+    size_t GetBytes(MemoryCategory category) const { return bytes[static_cast<size_t>(category)]; }
+};
+
+// One buffer or texture as the tracker sees it. Registers on construction and unregisters when
+// destroyed, so it lives next to the GL name (or the CPU data) it accounts for. Move-only.
+class TrackedMemory {
+public:
+    TrackedMemory() = default;
+    // owner is what the resource belongs to ("carousel", "mesh horse_02", "pass bloom"), name what
+    // it is to that owner ("vertex buffer", "level 2"), format its pixel or element layout
+    TrackedMemory(MemoryCategory category, std::string owner, std::string name, std::string format, size_t bytes);
+    ~TrackedMemory();
+    TrackedMemory(TrackedMemory&& other) noexcept;
+    TrackedMemory& operator=(TrackedMemory&& other) noexcept;
+    TrackedMemory(const TrackedMemory&) = delete;
+    TrackedMemory& operator=(const TrackedMemory&) = delete;
+
+    // For storage that is reallocated in place (orphaned or grown buffers); a no-op when unchanged
+    void Resize(size_t bytes);
+    void Release();
+    size_t GetBytes() const { return bytes; }
+
+private:
+    uint64_t id = 0;
+    size_t bytes = 0;
+};
+
+// Process-wide registry of the GPU and CPU memory held by the renderer and the imported model.
+// GPU sizes are what was requested from the driver, which may pad or compress differently; RGB
+// textures are counted as RGBA since that is how GPUs store them. Thread-safe, allocations register
+// from the loader threads as well as the render thread.
+class MemoryTracker {
+public:
+    static MemoryTotals GetTotals();
+    static const char* GetCategoryName(MemoryCategory category);
+    static bool IsGpu(MemoryCategory category) { return category < MemoryCategory::CpuGeometry; }
+
+    // "GPU 182.4 MB (textures 120.0 | geometry 41.2 | targets 20.1 | staging 1.1) | CPU 96.0 MB (...)"
+    static std::string FormatSummary();
+    // Every live allocation grouped by category, largest first, with size, format and owner
+    static void WriteBreakdown(std::ostream& out);
+    // {"gpuBytes", "cpuBytes", "peakGpuBytes", "peakCpuBytes", "categories": {"textures": {"bytes", "peakBytes", "resources"}, ...}}
+    static void WriteJson(std::ostream& out, const std::string& indent = "");
+
+    // Bytes of one level of a texture with the given GL internal format, block-compressed included
+    static size_t TextureLevelBytes(unsigned int internalFormat, int width, int height);
+    // "RGBA8", "BC1", "R11F_G11F_B10F", ...; "0x...." for formats not used here
+    static std::string FormatName(unsigned int internalFormat);
+};
+
+#endif
@@ -3,8 +3,25 @@
 #include "stb_image.h"
 
 Mesh::Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, unsigned int textureID, unsigned int normalMapID)
-    : vertices(vertices), indices(indices), textureID(textureID), normalMapID(normalMapID) {
+    : vertices(std::move(vertices)), indices(std::move(indices)), textureID(textureID), normalMapID(normalMapID) {
     setupMesh();
+    computeBounds();
+}
+
+void Mesh::computeBounds() {
+    if (vertices.empty()) return;
+
+    glm::vec3 minPos = vertices[0].position;
+    glm::vec3 maxPos = vertices[0].position;
+    for (const Vertex& vertex : vertices) {
+        minPos = glm::min(minPos, vertex.position);
+        maxPos = glm::max(maxPos, vertex.position);
+    }
+
+    boundsCenter = (minPos + maxPos) * 0.5f;
+    for (const Vertex& vertex : vertices) {
+        boundsRadius = glm::max(boundsRadius, glm::distance(boundsCenter, vertex.position));
+    }
 }
 
 void Mesh::setupMesh() {
@@ -37,20 +54,3 @@ void Mesh::setupMesh() {
 
     glBindVertexArray(0);
 }
-
-void Mesh::Draw() const {
-    // Bind diffuse texture (GL_TEXTURE0)
-    if (textureID) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-    }
-    // Bind normal map texture (GL_TEXTURE1)
-    if (normalMapID) {
-        glActiveTexture(GL_TEXTURE1);
-        glBindTexture(GL_TEXTURE_2D, normalMapID);
-    }
-    // Draw mesh
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
@@ -22,13 +22,15 @@ public:
     unsigned int textureID; // Diffuse
     unsigned int normalMapID = 0; // Normal Map
     unsigned int VAO;
+    glm::vec3 boundsCenter = glm::vec3(0.0f); // bounding sphere in mesh space, used for culling
+    float boundsRadius = 0.0f;
 
     Mesh(std::vector<Vertex> vertices, std::vector<unsigned int> indices, unsigned int textureID, unsigned int normalMapID = 0);
-    void Draw() const;
 
 private:
     unsigned int VBO, EBO;
     void setupMesh();
+    void computeBounds();
 };
 
 #endif
@@ -1,77 +1,213 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include "ModelLoader.h"
+#include "Frustum.h"
+#include "Profiler.h"
+#include "ShaderVariants.h"
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-ModelLoader::ModelLoader(const std::string& path) {
-    loadModel(path);
-}
+std::shared_ptr<const ModelData> ModelLoader::Import(const std::string& path, JobSystem& jobs, bool allowBakedTextures) {
+    PROFILE_SCOPE("ModelLoader::Import");
+    auto data = std::make_shared<ModelData>();
+    data->name = std::filesystem::path(path).stem().string();
 
-void ModelLoader::loadModel(const std::string& path) {
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path,
-        aiProcess_Triangulate |
-        aiProcess_GenSmoothNormals |
-        aiProcess_FlipUVs |
-        aiProcess_CalcTangentSpace);
+    const aiScene* scene;
+    {
+        PROFILE_SCOPE("Assimp ReadFile");
+        scene = importer.ReadFile(path,
+            aiProcess_Triangulate |
+            aiProcess_GenSmoothNormals |
+            aiProcess_FlipUVs |
+            aiProcess_CalcTangentSpace);
+    }
 
     if (!scene || !scene->mRootNode || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) {
         std::cerr << "ERROR::ASSIMP::" << importer.GetErrorString() << std::endl;
-        return;
+        return data;
     }
 
-    directory = std::filesystem::path(path).parent_path().string();
+    std::string directory = std::filesystem::path(path).parent_path().string();
 
+    // Texture paths per mesh; materials share textures, so each file is decoded only once
+    std::vector<std::string> diffusePaths(scene->mNumMeshes), normalPaths(scene->mNumMeshes);
+    std::map<std::string, std::shared_ptr<const ImageData>> images;
     for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
-        aiMesh* mesh = scene->mMeshes[i];
-        meshes.push_back(processMesh(mesh, scene));
+        aiMaterial* material = scene->mMaterials[scene->mMeshes[i]->mMaterialIndex];
 
-        std::string meshName = mesh->mName.C_Str();
-        std::transform(meshName.begin(), meshName.end(), meshName.begin(), ::tolower);
+        diffusePaths[i] = materialTexturePath(material, aiTextureType_DIFFUSE, directory);
+        normalPaths[i] = materialTexturePath(material, aiTextureType_NORMALS, directory);
+        if (normalPaths[i].empty()) {
+            std::cout << "[Fallback] Trying HEIGHT map instead of NORMAL map..." << std::endl;
+            normalPaths[i] = materialTexturePath(material, aiTextureType_HEIGHT, directory);
+        }
 
-        meshNames.push_back(meshName);
+        if (!diffusePaths[i].empty()) images[diffusePaths[i]] = nullptr;
+        if (!normalPaths[i].empty()) images[normalPaths[i]] = nullptr;
+    }
 
-        std::cout << "Mesh " << i << ": " << meshName << std::endl;
+    // JPEG decode is the slowest part of the import (unless the textures are baked), one job per texture
+    std::vector<std::map<std::string, std::shared_ptr<const ImageData>>::iterator> imageSlots;
+    for (auto it = images.begin(); it != images.end(); ++it) {
+        imageSlots.push_back(it);
+    }
+    JobCounter decoded;
+    for (auto slot : imageSlots) {
+        jobs.Run([slot, allowBakedTextures] {
+            std::cout << "Trying to load texture at path: " << slot->first << std::endl;
+            slot->second = AssetManager::ReadTexture(slot->first, allowBakedTextures);
+            }, &decoded);
+    }
 
-        if (meshName.find("bulb") != std::string::npos || meshName.find("light") != std::string::npos || meshName.find("lit") != std::string::npos) {
-            std::vector<glm::vec3> clusterCenters;
-            float clusterThreshold = 0.15f; // tweak if needed
+    // Vertex conversion and bulb clustering only touch the aiScene, so every mesh runs as its own job
+    data->meshes.resize(scene->mNumMeshes);
+    std::vector<std::vector<glm::vec3>> meshClusters(scene->mNumMeshes);
 
-            for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
-                glm::vec3 pos(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
-                bool foundCluster = false;
+    jobs.ParallelFor(scene->mNumMeshes, 1, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("Convert meshes");
+        for (size_t i = begin; i < end; i++) {
+            aiMesh* mesh = scene->mMeshes[i];
+            MeshData& meshData = data->meshes[i];
+            ConvertMesh(mesh, meshData.vertices, meshData.indices);
 
-                for (auto& center : clusterCenters) {
-                    if (glm::distance(center, pos) < clusterThreshold) {
-                        // Already covered by this cluster
-                        foundCluster = true;
-                        break;
-                    }
-                }
+            std::string meshName = mesh->mName.C_Str();
+            std::transform(meshName.begin(), meshName.end(), meshName.begin(), ::tolower);
+            meshData.name = meshName;
 
-                if (!foundCluster) {
-                    clusterCenters.push_back(pos);
-                    if (clusterCenters.size() >= 64) break;
-                }
+            if (meshName.find("bulb") != std::string::npos || meshName.find("light") != std::string::npos || meshName.find("lit") != std::string::npos) {
+                meshClusters[i] = ClusterBulbs(mesh);
             }
+        }
+        });
+    {
+        PROFILE_SCOPE("Wait for texture decode");
+        jobs.Wait(decoded);
+    }
+
+    convertNodes(scene->mRootNode, data->nodes);
+    std::cout << "Nodes: " << data->nodes.size() << std::endl;
+
+    for (unsigned int i = 0; i < scene->mNumMeshes; i++) {
+        MeshData& meshData = data->meshes[i];
+        if (!diffusePaths[i].empty()) meshData.diffuse = images[diffusePaths[i]];
+        if (!normalPaths[i].empty()) meshData.normalMap = images[normalPaths[i]];
+
+        std::cout << "Mesh " << i << ": " << meshData.name << std::endl;
 
-            std::cout << "Extracted " << clusterCenters.size() << " light bulbs from mesh '" << meshName << "'." << std::endl;
-            bulbPositions.insert(bulbPositions.end(), clusterCenters.begin(), clusterCenters.end());
+        if (!meshClusters[i].empty()) {
+            std::cout << "Extracted " << meshClusters[i].size() << " light bulbs from mesh '" << meshData.name << "'." << std::endl;
+            data->bulbPositions.insert(data->bulbPositions.end(), meshClusters[i].begin(), meshClusters[i].end());
+        }
+        data->memory.emplace_back(MemoryCategory::CpuGeometry, "mesh " + meshData.name, "imported vertices and indices", "vertex+index",
+            meshData.vertices.size() * sizeof(Vertex) + meshData.indices.size() * sizeof(unsigned int));
+    }
+    for (const auto& [imagePath, image] : images) {
+        if (!image || !image->Valid()) continue;
+        size_t imageBytes = image->pixels.size();
+        for (const std::vector<unsigned char>& mip : image->mips) {
+            imageBytes += mip.size();
         }
+        unsigned int format = image->compressedFormat ? image->compressedFormat
+            : image->channels == 1 ? GL_RED : image->channels == 3 ? GL_RGB : GL_RGBA;
+        data->memory.emplace_back(MemoryCategory::CpuImages, data->name, std::filesystem::path(imagePath).filename().string(),
+            MemoryTracker::FormatName(format), imageBytes);
     }
 
 
     //find the total meshes of the model
-    //std::cout << "Total meshes: " << meshes.size() << std::endl;
+    //std::cout << "Total meshes: " << data->meshes.size() << std::endl;
+    return data;
+}
+
+ModelLoader::ModelLoader(const ModelData& data, JobSystem& jobs, TextureStreamer& textures)
+    : bulbPositions(data.bulbPositions), jobs(jobs) {
+    PROFILE_SCOPE("ModelLoader upload");
+    std::map<const ImageData*, unsigned int> uploaded;
+
+    meshes.reserve(data.meshes.size());
+    for (const MeshData& meshData : data.meshes) {
+        unsigned int textureID = uploadTexture(meshData.diffuse, textures, uploaded, data.name, "diffuse of " + meshData.name);
+        unsigned int normalMapID = uploadTexture(meshData.normalMap, textures, uploaded, data.name, "normal map of " + meshData.name);
+        std::cout << "Texture ID: " << textureID << ", NormalMap ID: " << normalMapID << std::endl;
+
+        meshes.emplace_back(meshData.vertices, meshData.indices, textureID, normalMapID);
+        size_t vertexBytes = meshData.vertices.size() * sizeof(Vertex), indexBytes = meshData.indices.size() * sizeof(unsigned int);
+        std::string owner = "mesh " + meshData.name;
+        memory.emplace_back(MemoryCategory::Geometry, owner, "vertex buffer", "vertex " + std::to_string(sizeof(Vertex)) + " B", vertexBytes);
+        memory.emplace_back(MemoryCategory::Geometry, owner, "index buffer", "uint32", indexBytes);
+        memory.emplace_back(MemoryCategory::CpuGeometry, owner, "copy kept by Mesh", "vertex+index", vertexBytes + indexBytes);
+        meshNames.push_back(meshData.name);
+
+        // The shader variant is fixed per mesh: bulbs glow, everything else is lit
+        uint32_t features = 0;
+        if (meshData.name.find("lit") != std::string::npos ||
+            meshData.name.find("bulb") != std::string::npos ||
+            meshData.name.find("light") != std::string::npos) {
+            features = ShaderFeatureBulbEmissive;
+        }
+        else if (normalMapID) {
+            features = ShaderFeatureNormalMap;
+        }
+        auto known = std::find(featureSets.begin(), featureSets.end(), features);
+        meshVariant.push_back(known - featureSets.begin());
+        if (known == featureSets.end()) {
+            featureSets.push_back(features);
+        }
+    }
+}
+
+std::vector<glm::vec3> ModelLoader::ClusterBulbs(const aiMesh* mesh) {
+    std::vector<glm::vec3> clusterCenters;
+    float clusterThreshold = 0.15f; // tweak if needed
+
+    for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+        glm::vec3 pos(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+        bool foundCluster = false;
+
+        for (auto& center : clusterCenters) {
+            if (glm::distance(center, pos) < clusterThreshold) {
+                // Already covered by this cluster
+                foundCluster = true;
+                break;
+            }
+        }
+
+        if (!foundCluster) {
+            clusterCenters.push_back(pos);
+            if (clusterCenters.size() >= 64) break;
+        }
+    }
+    return clusterCenters;
 }
 
-Mesh ModelLoader::processMesh(aiMesh* mesh, const aiScene* scene) {
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+// Depth first, so every node comes after its parent
+void ModelLoader::convertNodes(const aiNode* root, std::vector<SceneNodeData>& nodes) {
+    std::vector<std::pair<const aiNode*, int>> pending = { { root, -1 } };
+    while (!pending.empty()) {
+        auto [node, parent] = pending.back();
+        pending.pop_back();
+
+        SceneNodeData nodeData;
+        nodeData.name = node->mName.C_Str();
+        nodeData.parent = parent;
+        // aiMatrix4x4 is row-major
+        nodeData.local = glm::transpose(glm::make_mat4(&node->mTransformation.a1));
+        nodeData.meshes.assign(node->mMeshes, node->mMeshes + node->mNumMeshes);
+        nodes.push_back(std::move(nodeData));
+
+        int index = static_cast<int>(nodes.size()) - 1;
+        for (unsigned int i = node->mNumChildren; i > 0; --i) {
+            pending.push_back({ node->mChildren[i - 1], index });
+        }
+    }
+}
 
+void ModelLoader::ConvertMesh(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices) {
+    vertices.reserve(mesh->mNumVertices);
     for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
         Vertex vertex;
         vertex.position = glm::vec3(
@@ -100,99 +236,85 @@ Mesh ModelLoader::processMesh(aiMesh* mesh, const aiScene* scene) {
         vertices.push_back(vertex);
     }
 
+    indices.reserve(mesh->mNumFaces * 3);
     for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-        aiFace face = mesh->mFaces[i];
+        const aiFace& face = mesh->mFaces[i];
         for (unsigned int j = 0; j < face.mNumIndices; j++)
             indices.push_back(face.mIndices[j]);
     }
-
-    unsigned int textureID = 0;
-    unsigned int normalMapID = 0;
-
-    if (mesh->mMaterialIndex >= 0) {
-        aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-        textureID = loadMaterialTexture(material, aiTextureType_DIFFUSE);
-        normalMapID = loadMaterialTexture(material, aiTextureType_NORMALS);
-
-        if (!normalMapID) {
-            std::cout << "[Fallback] Trying HEIGHT map instead of NORMAL map..." << std::endl;
-            normalMapID = loadMaterialTexture(material, aiTextureType_HEIGHT);
-        }
-
-        std::cout << "Texture ID: " << textureID << ", NormalMap ID: " << normalMapID << std::endl;
-    }
-
-    return Mesh(vertices, indices, textureID, normalMapID);
 }
 
-unsigned int ModelLoader::loadMaterialTexture(aiMaterial* mat, aiTextureType type) {
+std::string ModelLoader::materialTexturePath(aiMaterial* mat, aiTextureType type, const std::string& directory) {
     aiString str;
     if (mat->GetTexture(type, 0, &str) != AI_SUCCESS) {
-        return 0;
+        return std::string();
     }
 
     std::filesystem::path texturePath = std::filesystem::path(directory).parent_path() / "textures" / std::filesystem::path(str.C_Str()).filename();
-    std::string fullPath = texturePath.string();
-    int width, height, nrComponents;
-    std::cout << "Trying to load texture at path: " << fullPath << std::endl;
     std::cout << "Assimp texture name: " << str.C_Str() << std::endl;
-    unsigned char* data = stbi_load(fullPath.c_str(), &width, &height, &nrComponents, 0);
+    return texturePath.string();
+}
 
-    if (!data) {
-        std::cerr << "Failed to load texture at path: " << fullPath << std::endl;
+unsigned int ModelLoader::uploadTexture(const std::shared_ptr<const ImageData>& image, TextureStreamer& textures,
+    std::map<const ImageData*, unsigned int>& uploaded, const std::string& owner, const std::string& name) {
+    if (!image || !image->Valid()) {
         return 0;
     }
+    auto existing = uploaded.find(image.get());
+    if (existing != uploaded.end()) {
+        return existing->second;
+    }
 
-    GLenum format = nrComponents == 3 ? GL_RGB : GL_RGBA;
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    stbi_image_free(data);
+    // Pixels and the CPU-built mip chain are streamed over the next frames
+    unsigned int textureID = textures.Enqueue(image, GL_REPEAT, true, owner, name);
+    uploaded[image.get()] = textureID;
     return textureID;
 }
 
-// Draw method with vertical horse animation
-void ModelLoader::Draw(float horseTime, unsigned int shaderProgram, const glm::mat4& baseModel) const {
-    for (size_t i = 0; i < meshes.size(); ++i) {
-        // Base transform matrix for each mesh
-        glm::mat4 transform = baseModel;
-
-        // Apply bouncing only to selected horse meshes by index
-        if (i == 0) {
-            float verticalOffset = sin(horseTime) * 2.8f;
-            transform = glm::translate(transform, glm::vec3(0.0f, 0.0f, verticalOffset));//Z acts as Y, because the model
-        //had to be rotated by -90 degrees in order to look good in the view.
-        }
-        else if (i == 1) {
-            //pi<float> does the movement intercalation effect, the multiplier allows for further movement up and down
-            float verticalOffset = sin(horseTime + glm::pi<float>()) * 2.8f;
-            transform = glm::translate(transform, glm::vec3(0.0f, 0.0f, verticalOffset));
+// Queues the meshes at the transforms the simulation animated
+void ModelLoader::Submit(const std::vector<glm::mat4>& meshTransforms, const std::vector<unsigned int>& variantPrograms, const glm::mat4& view,
+    const glm::mat4& projection, RenderQueue& queue) const {
+    // Frustum culling runs on the job system, GL submission stays on this thread
+    PROFILE_SCOPE("Carousel meshes");
+    culledMeshCount = 0;
+    drawnTriangleCount = 0;
+    if (meshTransforms.size() != meshes.size()) {
+        culledMeshCount = meshes.size(); // the simulation has not picked up the model yet
+        return;
+    }
+    meshDepths.resize(meshes.size());
+    meshVisible.resize(meshes.size());
+    Frustum frustum(projection * view);
+
+    jobs.ParallelFor(meshes.size(), 4, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("Cull meshes");
+        for (size_t i = begin; i < end; ++i) {
+            const glm::mat4& transform = meshTransforms[i];
+            glm::vec3 center = glm::vec3(transform * glm::vec4(meshes[i].boundsCenter, 1.0f));
+            float scale = glm::max(glm::length(glm::vec3(transform[0])),
+                glm::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+            meshVisible[i] = frustum.IntersectsSphere(center, meshes[i].boundsRadius * scale);
+            meshDepths[i] = -(view * glm::vec4(center, 1.0f)).z;
         }
+        });
 
-        // Upload model matrix to shader
-        glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, glm::value_ptr(transform));
-
-        const std::string& meshName = meshNames[i];
-        if (meshName.find("lit") != std::string::npos ||
-            meshName.find("bulb") != std::string::npos ||
-            meshName.find("light") != std::string::npos) {
-            glUniform1i(glGetUniformLocation(shaderProgram, "forceBulbColor"), 1);
-        }
-        else {
-            glUniform1i(glGetUniformLocation(shaderProgram, "forceBulbColor"), 0);
+    // The queue orders the draws by variant and texture, mesh order no longer matters
+    for (size_t i = 0; i < meshes.size(); ++i) {
+        if (!meshVisible[i]) {
+            ++culledMeshCount;
+            continue;
         }
-
-        meshes[i].Draw();
+        drawnTriangleCount += meshes[i].indices.size() / 3;
+
+        // Both units are always bound, so a mesh without a texture never picks up the previous mesh's
+        DrawPacket packet;
+        packet.program = variantPrograms[meshVariant[i]];
+        packet.vertexArray = meshes[i].VAO;
+        packet.count = static_cast<GLsizei>(meshes[i].indices.size());
+        packet.textures[0] = { GL_TEXTURE_2D, meshes[i].textureID, true };
+        packet.textures[1] = { GL_TEXTURE_2D, meshes[i].normalMapID, true };
+        packet.model = &meshTransforms[i];
+        queue.Submit(RenderLayer::Opaque, packet, meshDepths[i]);
 
         //to see which meshes are the horses (the ones that are moving)
         //std::cout << "Drawing mesh " << i << std::endl;
@@ -1,28 +1,86 @@
-
 #ifndef MODEL_LOADER_H
 #define MODEL_LOADER_H
 
+#include <cstdint>
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
+#include "AssetManager.h"
+#include "JobSystem.h"
+#include "MemoryTracker.h"
 #include "Mesh.h"
+#include "RenderQueue.h"
+#include "SceneGraph.h"
+#include "TextureStreamer.h"
+
+// CPU side of one mesh, produced off the GL thread
+struct MeshData {
+    std::string name; // lower case
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    std::shared_ptr<const ImageData> diffuse;
+    std::shared_ptr<const ImageData> normalMap;
+};
+
+// Everything Import() reads from disk: geometry, decoded textures, the node hierarchy and the
+// extracted bulb lights
+struct ModelData {
+    std::string name; // file name without extension, the owner of its memory in the MemoryTracker
+    std::vector<MeshData> meshes;
+    std::vector<SceneNodeData> nodes; // parents first, the meshes hang off these
+    std::vector<glm::vec3> bulbPositions;
+    std::vector<TrackedMemory> memory; // the geometry and decoded images above
+};
 
 class ModelLoader {
 public:
-    ModelLoader(const std::string& path);
-    void Draw(float horseTime, unsigned int shaderProgram, const glm::mat4& baseModel) const;
+    // Assimp import, vertex conversion, bulb clustering and texture decode. Safe to call on any thread.
+    // allowBakedTextures picks up the .ctex files written by carousel_bake instead of the JPEGs.
+    static std::shared_ptr<const ModelData> Import(const std::string& path, JobSystem& jobs, bool allowBakedTextures);
+
+    // Creates the GL buffers and queues the textures on the streamer, must run on the GL thread
+    ModelLoader(const ModelData& data, JobSystem& jobs, TextureStreamer& textures);
+    // Shader features (ShaderVariants.h) used by the meshes, each set once
+    const std::vector<uint32_t>& GetFeatureSets() const { return featureSets; }
+    // Culls the meshes and queues the visible ones as opaque draws. meshTransforms holds the world
+    // matrix of every mesh (FrameSnapshot) and must outlive the queue's Execute(), nothing is drawn
+    // while its size does not match. variantPrograms[i] is the program for GetFeatureSets()[i], with
+    // the frame uniforms already set.
+    void Submit(const std::vector<glm::mat4>& meshTransforms, const std::vector<unsigned int>& variantPrograms, const glm::mat4& view,
+        const glm::mat4& projection, RenderQueue& queue) const;
     const std::vector<glm::vec3>& GetBulbPositions() const { return bulbPositions; }
+    size_t GetCulledMeshCount() const { return culledMeshCount; }
+    // Queued by the last Submit()
+    size_t GetDrawnMeshCount() const { return meshes.size() - culledMeshCount; }
+    size_t GetDrawnTriangleCount() const { return drawnTriangleCount; }
+
+    // Steps of Import(), public so carousel_bench can time them on their own
+    static void ConvertMesh(const aiMesh* mesh, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+    static std::vector<glm::vec3> ClusterBulbs(const aiMesh* mesh);
 
 private:
     std::vector<Mesh> meshes;
-    std::string directory;
     std::vector<glm::vec3> bulbPositions;
     std::vector<std::string> meshNames;
-    void loadModel(const std::string& path);
-    Mesh processMesh(aiMesh* mesh, const aiScene* scene);
-    unsigned int loadMaterialTexture(aiMaterial* mat, aiTextureType type);
+    std::vector<uint32_t> featureSets;
+    std::vector<size_t> meshVariant; // index into featureSets
+    std::vector<TrackedMemory> memory; // mesh buffers and the geometry copies the meshes keep
+    JobSystem& jobs;
+
+    // Per-frame scratch written by the culling jobs in Submit
+    mutable std::vector<float> meshDepths;
+    mutable std::vector<char> meshVisible;
+    mutable size_t culledMeshCount = 0;
+    mutable size_t drawnTriangleCount = 0;
+
+    static void convertNodes(const aiNode* root, std::vector<SceneNodeData>& nodes);
+    static std::string materialTexturePath(aiMaterial* mat, aiTextureType type, const std::string& directory);
+    static unsigned int uploadTexture(const std::shared_ptr<const ImageData>& image, TextureStreamer& textures,
+        std::map<const ImageData*, unsigned int>& uploaded, const std::string& owner, const std::string& name);
 };
 
 #endif
@@ -0,0 +1,218 @@
+#include "PostProcess.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include "Profiler.h"
+
+PostProcess::PostProcess(GpuTimers& timers)
+    : timers(timers) {
+    bloomPass = timers.AddPass("bloom");
+    tonemapPass = timers.AddPass("tonemap");
+    glGenVertexArrays(1, &emptyVertexArray);
+}
+
+PostProcess::~PostProcess() {
+    releaseTargets();
+    glDeleteVertexArrays(1, &emptyVertexArray);
+}
+
+void PostProcess::SetPrograms(unsigned int downsample, unsigned int upsample, unsigned int tonemap) {
+    downsampleProgram = downsample;
+    upsampleProgram = upsample;
+    tonemapProgram = tonemap;
+}
+
+glm::vec2 PostProcess::Target::GetUvScale() const {
+    return glm::vec2(static_cast<float>(renderWidth) / width, static_cast<float>(renderHeight) / height);
+}
+
+PostProcess::Target PostProcess::createTarget(int width, int height, GLenum format, const std::string& owner, const std::string& name) {
+    Target target;
+    target.width = width;
+    target.height = height;
+    target.renderWidth = width;
+    target.renderHeight = height;
+    glGenTextures(1, &target.texture);
+    glBindTexture(GL_TEXTURE_2D, target.texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    target.memory = TrackedMemory(MemoryCategory::RenderTargets, owner, name + ", " + std::to_string(width) + "x" + std::to_string(height),
+        MemoryTracker::FormatName(format), MemoryTracker::TextureLevelBytes(format, width, height));
+    // Bilinear taps do half the filtering work of the bloom and the tonemap's upsample
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &target.framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
+    return target;
+}
+
+void PostProcess::releaseTargets() {
+    auto release = [](Target& target) {
+        glDeleteFramebuffers(1, &target.framebuffer);
+        glDeleteTextures(1, &target.texture);
+        target = Target();
+    };
+    if (scene.framebuffer) release(scene);
+    for (Target& level : bloomLevels) {
+        release(level);
+    }
+    bloomLevels.clear();
+    if (sceneDepth) glDeleteRenderbuffers(1, &sceneDepth);
+    sceneDepth = 0;
+    sceneDepthMemory.Release();
+}
+
+bool PostProcess::Resize(int newWidth, int newHeight) {
+    if (newWidth == width && newHeight == height) return false;
+    PROFILE_SCOPE("Post process resize");
+    releaseTargets();
+    width = newWidth;
+    height = newHeight;
+    if (width <= 0 || height <= 0) return true;
+
+    scene = createTarget(width, height, GL_RGBA16F, "pass scene", "HDR color");
+    glGenRenderbuffers(1, &sceneDepth);
+    glBindRenderbuffer(GL_RENDERBUFFER, sceneDepth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    sceneDepthMemory = TrackedMemory(MemoryCategory::RenderTargets, "pass scene", "depth, " + std::to_string(width) + "x" + std::to_string(height),
+        MemoryTracker::FormatName(GL_DEPTH_COMPONENT24), MemoryTracker::TextureLevelBytes(GL_DEPTH_COMPONENT24, width, height));
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, sceneDepth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "[Post] HDR framebuffer " << width << "x" << height << " is incomplete" << std::endl;
+    }
+
+    // Bloom needs no alpha, the packed 32-bit float format halves its bandwidth
+    int levelWidth = width / 2, levelHeight = height / 2;
+    while (static_cast<int>(bloomLevels.size()) < MaxBloomLevels && std::min(levelWidth, levelHeight) >= MinBloomSize) {
+        bloomLevels.push_back(createTarget(levelWidth, levelHeight, GL_R11F_G11F_B10F, "pass bloom",
+            "level " + std::to_string(bloomLevels.size())));
+        levelWidth /= 2;
+        levelHeight /= 2;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    updateRenderSizes();
+    std::cout << "[Post] " << width << "x" << height << " RGBA16F scene, " << bloomLevels.size() << " bloom levels" << std::endl;
+    return true;
+}
+
+void PostProcess::SetRenderScale(float scale) {
+    scale = std::clamp(scale, 0.01f, 1.0f);
+    if (scale == renderScale) return;
+    renderScale = scale;
+    updateRenderSizes();
+}
+
+// Each bloom level renders at half the rendered part of the one before it, like the allocations
+void PostProcess::updateRenderSizes() {
+    if (!scene.framebuffer) return;
+    scene.renderWidth = std::clamp(static_cast<int>(std::lround(width * renderScale)), 1, width);
+    scene.renderHeight = std::clamp(static_cast<int>(std::lround(height * renderScale)), 1, height);
+    const Target* source = &scene;
+    for (Target& level : bloomLevels) {
+        level.renderWidth = std::clamp(source->renderWidth / 2, 1, level.width);
+        level.renderHeight = std::clamp(source->renderHeight / 2, 1, level.height);
+        source = &level;
+    }
+}
+
+void PostProcess::BeginScene() {
+    glBindFramebuffer(GL_FRAMEBUFFER, scene.framebuffer);
+    glViewport(0, 0, scene.renderWidth, scene.renderHeight);
+}
+
+void PostProcess::drawFullScreen(GLState& state) {
+    state.BindVertexArray(emptyVertexArray);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// Downsamples the scene through every level, then adds each level back onto the one above it
+void PostProcess::bloom(GLState& state) {
+    state.SetBlend(false);
+    state.UseProgram(downsampleProgram);
+    state.SetUniform("source", 0);
+    state.SetUniform("threshold", BloomThreshold);
+    state.SetUniform("knee", BloomKnee);
+    const Target* source = &scene;
+    for (size_t level = 0; level < bloomLevels.size(); ++level) {
+        const Target& target = bloomLevels[level];
+        glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+        glViewport(0, 0, target.renderWidth, target.renderHeight);
+        state.SetUniform("texelSize", source->GetTexelSize());
+        state.SetUniform("uvScale", source->GetUvScale());
+        state.SetUniform("prefilter", level == 0 ? 1 : 0);
+        state.BindTexture(0, GL_TEXTURE_2D, source->texture);
+        drawFullScreen(state);
+        source = &target;
+    }
+
+    state.UseProgram(upsampleProgram);
+    state.SetUniform("source", 0);
+    state.SetBlend(true);
+    state.SetBlendFunc(GL_ONE, GL_ONE);
+    for (size_t level = bloomLevels.size() - 1; level > 0; --level) {
+        const Target& smaller = bloomLevels[level];
+        const Target& target = bloomLevels[level - 1];
+        glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+        glViewport(0, 0, target.renderWidth, target.renderHeight);
+        state.SetUniform("texelSize", smaller.GetTexelSize());
+        state.SetUniform("uvScale", smaller.GetUvScale());
+        state.BindTexture(0, GL_TEXTURE_2D, smaller.texture);
+        drawFullScreen(state);
+    }
+}
+
+void PostProcess::Resolve(GLState& state, unsigned int outputFramebuffer) {
+    PROFILE_SCOPE("Post process");
+    if (!HasPrograms()) {
+        // Shaders still loading, show the scene as it is
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, scene.framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, outputFramebuffer);
+        glBlitFramebuffer(0, 0, scene.renderWidth, scene.renderHeight, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        return;
+    }
+
+    state.SetDepthTest(false);
+    if (!bloomLevels.empty()) {
+        GpuTimers::Scope gpuScope(timers, bloomPass);
+        bloom(state);
+    }
+    {
+        GpuTimers::Scope gpuScope(timers, tonemapPass);
+        glBindFramebuffer(GL_FRAMEBUFFER, outputFramebuffer);
+        glViewport(0, 0, width, height);
+        state.SetBlend(false);
+        state.UseProgram(tonemapProgram);
+        state.SetUniform("scene", 0);
+        state.SetUniform("bloom", 1);
+        state.SetUniform("bloomStrength", bloomLevels.empty() ? 0.0f : BloomStrength);
+        state.SetUniform("exposure", Exposure);
+        state.SetUniform("sceneUvScale", scene.GetUvScale());
+        state.SetUniform("sceneTexelSize", scene.GetTexelSize());
+        if (!bloomLevels.empty()) {
+            state.SetUniform("bloomUvScale", bloomLevels[0].GetUvScale());
+            state.SetUniform("bloomTexelSize", bloomLevels[0].GetTexelSize());
+        }
+        state.BindTexture(0, GL_TEXTURE_2D, scene.texture);
+        state.BindTexture(1, GL_TEXTURE_2D, bloomLevels.empty() ? 0 : bloomLevels[0].texture);
+        drawFullScreen(state);
+    }
+    // Nothing that is rendered into next frame may stay bound for sampling
+    state.BindTexture(0, GL_TEXTURE_2D, 0);
+    state.BindTexture(1, GL_TEXTURE_2D, 0);
+
+    double averageMs = GetAverageMs();
+    if (averageMs > BudgetMs && !overBudget) {
+        std::cout << "[Post] Bloom and tonemap average " << averageMs << " ms, over the " << BudgetMs << " ms budget" << std::endl;
+    }
+    overBudget = averageMs > BudgetMs;
+}
+
+double PostProcess::GetAverageMs() const {
+    return timers.GetAverageMs(bloomPass) + timers.GetAverageMs(tonemapPass);
+}
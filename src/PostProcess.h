@@ -0,0 +1,92 @@
+#ifndef POST_PROCESS_H
+#define POST_PROCESS_H
+
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "GLState.h"
+#include "GpuTimers.h"
+#include "MemoryTracker.h"
+
+// HDR scene target and the post chain that resolves it. The scene renders into an RGBA16F
+// framebuffer in linear light, nothing is clamped. Resolve() then:
+//   bloom    the bright parts are downsampled into a mip chain starting at half resolution
+//            (13-tap filter, the first pass keeps only what exceeds BloomThreshold) and added
+//            back up the chain with a tent filter
+//   tonemap  one full-screen pass adds the bloom, applies the ACES curve and encodes sRGB
+// into the output framebuffer, so the scene shaders no longer gamma correct per fragment.
+// Both steps are GPU timed; together they should stay under BudgetMs.
+// With a render scale below 1 (dynamic resolution) the scene and the bloom chain only use the
+// lower-left part of their targets, so changing the scale never reallocates anything; the
+// tonemap pass upscales that part bilinearly to the full output.
+// Must only be used on the thread that holds the GL context.
+class PostProcess {
+public:
+    static constexpr int MaxBloomLevels = 6;
+    static constexpr int MinBloomSize = 8;        // pixels, the chain stops before a level gets smaller
+    static constexpr float BloomThreshold = 1.0f; // linear scene value where bloom starts
+    static constexpr float BloomKnee = 0.5f;      // soft transition below the threshold
+    static constexpr float BloomStrength = 0.15f;
+    static constexpr float Exposure = 1.0f;
+    static constexpr double BudgetMs = 1.0;       // bloom and tonemap together
+
+    // Queries for "bloom" and "tonemap" are added to timers
+    explicit PostProcess(GpuTimers& timers);
+    ~PostProcess();
+    PostProcess(const PostProcess&) = delete;
+    PostProcess& operator=(const PostProcess&) = delete;
+
+    // Programs for post.vs with bloom_down.fs, bloom_up.fs and tonemap.fs. Until they are set
+    // Resolve() copies the scene as it is.
+    void SetPrograms(unsigned int downsample, unsigned int upsample, unsigned int tonemap);
+    bool HasPrograms() const { return downsampleProgram && upsampleProgram && tonemapProgram; }
+
+    // Reallocates the targets for a new output size. Returns true when it did, the texture bindings
+    // it changed bypass GLState so the caller must invalidate it.
+    bool Resize(int width, int height);
+    // Fraction of the output size, per axis, that the scene renders at; clamped to (0, 1]
+    void SetRenderScale(float scale);
+    // Binds the HDR framebuffer and its scaled viewport for the scene passes
+    void BeginScene();
+    // Runs the chain and writes the final image into outputFramebuffer, left bound with a full viewport
+    void Resolve(GLState& state, unsigned int outputFramebuffer);
+
+    int GetBloomLevelCount() const { return static_cast<int>(bloomLevels.size()); }
+    float GetRenderScale() const { return renderScale; }
+    int GetRenderWidth() const { return scene.renderWidth; }
+    int GetRenderHeight() const { return scene.renderHeight; }
+    // Rolling GPU average of bloom and tonemap
+    double GetAverageMs() const;
+
+private:
+    struct Target {
+        GLuint framebuffer = 0, texture = 0;
+        int width = 0, height = 0;             // allocated
+        int renderWidth = 0, renderHeight = 0; // rendered part at the current scale
+        TrackedMemory memory;
+        glm::vec2 GetUvScale() const;
+        glm::vec2 GetTexelSize() const { return glm::vec2(1.0f / width, 1.0f / height); }
+    };
+
+    void releaseTargets();
+    void updateRenderSizes();
+    static Target createTarget(int width, int height, GLenum format, const std::string& owner, const std::string& name);
+    void bloom(GLState& state);
+    void drawFullScreen(GLState& state);
+
+    GpuTimers& timers;
+    int bloomPass, tonemapPass;
+    unsigned int downsampleProgram = 0, upsampleProgram = 0, tonemapProgram = 0;
+    GLuint emptyVertexArray = 0; // the full-screen triangle comes from gl_VertexID
+
+    int width = 0, height = 0;
+    float renderScale = 1.0f;
+    Target scene;
+    GLuint sceneDepth = 0;
+    TrackedMemory sceneDepthMemory;
+    std::vector<Target> bloomLevels; // [0] is half resolution
+    bool overBudget = false; // logged when the average crosses BudgetMs
+};
+
+#endif
@@ -0,0 +1,135 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Profiler::enabled{ false };
+
+namespace {
+constexpr size_t RingSize = 1 << 16; // events kept per thread, about a minute of a busy render thread
+
+struct Event {
+    const char* name;
+    uint64_t begin, end;
+};
+
+// Written only by its thread. Shared ownership keeps the events of finished threads
+// (e.g. model import jobs on a loader that has exited) exportable.
+struct ThreadBuffer {
+    std::string name;
+    int id = 0;
+    std::vector<Event> events = std::vector<Event>(RingSize);
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<uint64_t> generation{ 0 };
+};
+
+std::mutex registryMutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+std::atomic<uint64_t> captureGeneration{ 0 };
+const auto epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& threadBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+        auto created = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        created->id = static_cast<int>(registry.size()) + 1;
+        created->name = "Thread " + std::to_string(created->id);
+        registry.push_back(created);
+        return created;
+    }();
+    return *buffer;
+}
+
+// Trace viewers choke on raw control characters and quotes in names
+std::string escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+}
+
+void Profiler::SetEnabled(bool enable) {
+    if (enable && !IsEnabled()) {
+        captureGeneration.fetch_add(1, std::memory_order_relaxed); // buffers reset lazily on their next event
+    }
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+uint64_t Profiler::Now() {
+    // +1 so a valid timestamp is never 0, which ProfileScope uses for "not recording"
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch).count()) + 1;
+}
+
+void Profiler::Record(const char* name, uint64_t beginNanoseconds, uint64_t endNanoseconds) {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t generation = captureGeneration.load(std::memory_order_relaxed);
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    if (buffer.generation.load(std::memory_order_relaxed) != generation) {
+        buffer.generation.store(generation, std::memory_order_relaxed);
+        index = 0;
+    }
+    buffer.events[index % RingSize] = Event{ name, beginNanoseconds, endNanoseconds };
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::WriteChromeTrace(const std::filesystem::path& path) {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "[Profiler] Could not write " << path.string() << std::endl;
+        return false;
+    }
+
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = registry;
+    }
+
+    // Complete ("X") events in microseconds, plus one metadata event naming each thread.
+    // A thread still recording may overwrite its oldest slots while they are copied here, which
+    // can only affect events at the far end of a full ring.
+    uint64_t generation = captureGeneration.load(std::memory_order_relaxed);
+    size_t eventCount = 0;
+    file << std::fixed << std::setprecision(3);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto& buffer : buffers) {
+        std::string name;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            name = buffer->name;
+        }
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+            << ",\"args\":{\"name\":\"" << escape(name) << "\"}}";
+        first = false;
+
+        if (buffer->generation.load(std::memory_order_relaxed) != generation) continue; // nothing from this capture
+        uint64_t written = buffer->written.load(std::memory_order_acquire);
+        for (uint64_t i = written - std::min<uint64_t>(written, RingSize); i < written; ++i) {
+            const Event& event = buffer->events[i % RingSize];
+            file << ",\n{\"name\":\"" << escape(event.name) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+                << ",\"ts\":" << event.begin / 1000.0 << ",\"dur\":" << (event.end - event.begin) / 1000.0 << "}";
+            ++eventCount;
+        }
+    }
+    file << "\n]}\n";
+
+    std::cout << "[Profiler] " << eventCount << " events from " << buffers.size() << " threads written to " << path.string() << std::endl;
+    return static_cast<bool>(file);
+}
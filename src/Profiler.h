@@ -0,0 +1,55 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+
+// CPU scope profiler. PROFILE_SCOPE("Name") times the rest of the enclosing block and appends one
+// event to a ring buffer owned by the calling thread, so recording never takes a lock. While
+// capture is off a scope costs one relaxed atomic load. Names must be string literals (only the
+// pointer is stored). WriteChromeTrace() merges every thread's buffer into a trace that
+// chrome://tracing and ui.perfetto.dev open directly.
+// Define CAROUSEL_NO_PROFILER to compile the scopes out entirely.
+class Profiler {
+public:
+    // Starting a capture drops the events of the previous one
+    static void SetEnabled(bool enable);
+    static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Shown as the thread's row in the trace viewer, call once at the top of each thread
+    static void SetThreadName(const char* name);
+
+    static uint64_t Now();
+    static void Record(const char* name, uint64_t beginNanoseconds, uint64_t endNanoseconds);
+
+    // The newest events of each thread (up to the ring size) as Chrome trace event JSON
+    static bool WriteChromeTrace(const std::filesystem::path& path);
+
+private:
+    static std::atomic<bool> enabled;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name), begin(Profiler::IsEnabled() ? Profiler::Now() : 0) {}
+    ~ProfileScope() {
+        if (begin) Profiler::Record(name, begin, Profiler::Now());
+    }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name;
+    uint64_t begin;
+};
+
+#ifdef CAROUSEL_NO_PROFILER
+#define PROFILE_SCOPE(name)
+#else
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#endif
+
+#endif
@@ -0,0 +1,149 @@
+#include "ProgramCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+#include "GLExtensions.h"
+
+namespace {
+constexpr GLenum GL_PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+constexpr GLenum GL_PROGRAM_BINARY_LENGTH = 0x8741;
+constexpr GLenum GL_NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+
+// Cache entry (.bin), the driver's blob follows the header
+struct ProgramBinaryHeader {
+    char magic[4];          // "CPB1"
+    uint64_t sourceHash;
+    uint64_t driverHash;
+    uint32_t binaryFormat;
+    uint32_t binarySize;
+};
+
+// FNV-1a, continued from a previous hash
+uint64_t hashBytes(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+uint64_t hashSources(const std::string& vertexSource, const std::string& fragmentSource) {
+    uint64_t hash = hashBytes(vertexSource.data(), vertexSource.size());
+    hash = hashBytes("\0", 1, hash); // "ab"+"c" and "a"+"bc" differ
+    return hashBytes(fragmentSource.data(), fragmentSource.size(), hash);
+}
+
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+}
+
+ProgramCache::ProgramCache(std::filesystem::path directory)
+    : directory(std::move(directory)) {
+    if (GetGLVersion() >= 41 || HasGLExtension("GL_ARB_get_program_binary")) {
+        getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(GetGLProcAddress("glGetProgramBinary"));
+        programBinary = reinterpret_cast<ProgramBinaryProc>(GetGLProcAddress("glProgramBinary"));
+        programParameteri = reinterpret_cast<ProgramParameteriProc>(GetGLProcAddress("glProgramParameteri"));
+    }
+    GLint formatCount = 0;
+    if (getProgramBinary && programBinary && programParameteri) {
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    }
+    supported = formatCount > 0;
+
+    std::string driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+    driverHash = hashBytes(driver.data(), driver.size());
+
+    std::error_code error;
+    if (supported && !std::filesystem::create_directories(this->directory, error) && error) {
+        std::cerr << "[ProgramCache] Could not create " << this->directory.string() << ": " << error.message() << std::endl;
+        supported = false;
+    }
+    std::cout << "[ProgramCache] " << (supported ? "Program binaries cached in " + this->directory.string()
+        : std::string("Driver has no program binary formats, compiling every run")) << std::endl;
+}
+
+std::filesystem::path ProgramCache::entryPath(uint64_t sourceHash) const {
+    char name[40];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(hashBytes(&driverHash, sizeof(driverHash), sourceHash)));
+    return directory / name;
+}
+
+unsigned int ProgramCache::Load(const std::string& vertexSource, const std::string& fragmentSource) {
+    if (!supported) return 0;
+    uint64_t sourceHash = hashSources(vertexSource, fragmentSource);
+
+    std::ifstream file(entryPath(sourceHash), std::ios::binary);
+    ProgramBinaryHeader header;
+    if (!file || !file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, "CPB1", 4) != 0
+        || header.sourceHash != sourceHash || header.driverHash != driverHash) {
+        ++misses;
+        return 0;
+    }
+    std::vector<char> binary(header.binarySize);
+    if (!file.read(binary.data(), binary.size())) {
+        ++misses;
+        return 0;
+    }
+
+    unsigned int program = glCreateProgram();
+    programBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // Rejected by the driver, the recompiled program overwrites the entry
+        glDeleteProgram(program);
+        ++misses;
+        return 0;
+    }
+    ++hits;
+    return program;
+}
+
+void ProgramCache::PrepareLink(unsigned int program) const {
+    if (supported) {
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+}
+
+void ProgramCache::Store(unsigned int program, const std::string& vertexSource, const std::string& fragmentSource) {
+    if (!supported) return;
+    GLint linked = GL_FALSE, length = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (!linked || length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(program, length, &length, &format, binary.data());
+
+    ProgramBinaryHeader header = {};
+    std::memcpy(header.magic, "CPB1", 4);
+    header.sourceHash = hashSources(vertexSource, fragmentSource);
+    header.driverHash = driverHash;
+    header.binaryFormat = format;
+    header.binarySize = static_cast<uint32_t>(length);
+
+    // Written aside and renamed, so a second viewer never reads half an entry
+    std::filesystem::path path = entryPath(header.sourceHash);
+    std::filesystem::path temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(binary.data(), length);
+        if (!file) {
+            std::cerr << "[ProgramCache] Could not write " << temporary.string() << std::endl;
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        std::filesystem::remove(temporary, error);
+    }
+}
@@ -0,0 +1,48 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <glad/glad.h>
+
+// Linked shader programs saved with glGetProgramBinary (ARB_get_program_binary, core in GL 4.1)
+// and restored with glProgramBinary on later runs, so startup skips GLSL compilation. A binary is
+// keyed by a hash of the sources and of the driver's vendor/renderer/version strings; the driver
+// may still reject it (e.g. after an update that kept the version string), in which case Load()
+// returns 0 and the caller compiles from source and stores the new binary.
+// Must only be used on the thread that holds the GL context.
+class ProgramCache {
+public:
+    explicit ProgramCache(std::filesystem::path directory);
+
+    bool IsSupported() const { return supported; }
+
+    // A linked program for these sources, or 0 on a miss
+    unsigned int Load(const std::string& vertexSource, const std::string& fragmentSource);
+    // Call between attaching the shaders and glLinkProgram so the driver keeps the binary
+    void PrepareLink(unsigned int program) const;
+    // Writes the binary of a successfully linked program
+    void Store(unsigned int program, const std::string& vertexSource, const std::string& fragmentSource);
+
+    int GetHitCount() const { return hits; }
+    int GetMissCount() const { return misses; }
+
+private:
+    std::filesystem::path entryPath(uint64_t sourceHash) const;
+
+    std::filesystem::path directory;
+    uint64_t driverHash = 0; // of vendor, renderer and version, also stored in every entry
+    bool supported = false;
+    int hits = 0, misses = 0;
+
+    // Not in glad's GL 3.3 core, loaded through GetGLProcAddress
+    typedef void (APIENTRYP GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (APIENTRYP ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+    typedef void (APIENTRYP ProgramParameteriProc)(GLuint, GLenum, GLint);
+    GetProgramBinaryProc getProgramBinary = nullptr;
+    ProgramBinaryProc programBinary = nullptr;
+    ProgramParameteriProc programParameteri = nullptr;
+};
+
+#endif
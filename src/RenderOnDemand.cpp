@@ -0,0 +1,40 @@
+#include "RenderOnDemand.h"
+#include <algorithm>
+#include "Profiler.h"
+
+RenderOnDemand::RenderOnDemand(double idleFrameRate)
+    : idleInterval(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / std::max(idleFrameRate, 0.1)))) {
+}
+
+void RenderOnDemand::Wake() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        wakeRequested = true;
+    }
+    woken.notify_one();
+}
+
+bool RenderOnDemand::WaitIfIdle(uint32_t changes) {
+    if (changes != 0 || rendererBusy) {
+        return false;
+    }
+    PROFILE_SCOPE("Idle");
+    std::unique_lock<std::mutex> lock(mutex);
+    // An event that arrived during the tick is still latched and ends the wait at once
+    auto start = std::chrono::steady_clock::now();
+    woken.wait_for(lock, idleInterval, [this] { return wakeRequested; });
+    wakeRequested = false;
+    idleTime += std::chrono::steady_clock::now() - start;
+    return true;
+}
+
+float RenderOnDemand::SampleIdleFraction() {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - sampleStart).count();
+    float fraction = elapsed > 0.0 ? static_cast<float>(std::chrono::duration<double>(idleTime).count() / elapsed) : 0.0f;
+    sampleStart = now;
+    idleTime = std::chrono::steady_clock::duration::zero();
+    return fraction;
+}
@@ -0,0 +1,43 @@
+#ifndef RENDER_ON_DEMAND_H
+#define RENDER_ON_DEMAND_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+// Idle mode for unattended displays (--render-on-demand). Normally the simulation ticks and the
+// renderer draws at 60 Hz even when nothing moves. In this mode a tick that changed nothing
+// (FrameSnapshot::changes == 0) puts the simulation thread to sleep until a window or input
+// event wakes it, or until the idle frame interval passes. The renderer only draws what the
+// simulation publishes, so a still scene costs a few frames a second for the bulb flicker.
+class RenderOnDemand {
+public:
+    explicit RenderOnDemand(double idleFrameRate);
+
+    // Called by the GLFW callbacks (input, resize, refresh) and at shutdown
+    void Wake();
+    // The render thread keeps the simulation awake while it still has assets to bring in
+    void SetRendererBusy(bool busy) { rendererBusy = busy; }
+
+    // Simulation thread, after publishing a tick. Returns false at once if the tick changed
+    // something or the renderer is busy. Otherwise sleeps until Wake() or the idle frame
+    // interval and returns true.
+    bool WaitIfIdle(uint32_t changes);
+
+    // Fraction of the time since the previous call spent asleep
+    float SampleIdleFraction();
+
+private:
+    std::chrono::steady_clock::duration idleInterval;
+    std::atomic<bool> rendererBusy{ true };
+
+    std::mutex mutex;
+    std::condition_variable woken;
+    bool wakeRequested = false;
+    std::chrono::steady_clock::duration idleTime{ 0 };
+    std::chrono::steady_clock::time_point sampleStart = std::chrono::steady_clock::now();
+};
+
+#endif
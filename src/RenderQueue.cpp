@@ -0,0 +1,146 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include "Profiler.h"
+
+namespace {
+// Key layout, most significant bits first. The layer always leads; inside a layer opaque draws
+// are grouped by state and only then ordered front to back (to help early depth rejection),
+// translucent ones are ordered by depth alone so they blend correctly.
+//
+//   Opaque, Sky   | layer:2 | program:12 | material:16 | depth:24       | unused:10 |
+//   Translucent   | layer:2 | far-to-near depth:24 | program:12 | material:16 | unused:10 |
+constexpr int LayerShift = 62;
+constexpr uint32_t ProgramBits = 12, MaterialBits = 16, DepthBits = 24;
+constexpr uint32_t ProgramMask = (1u << ProgramBits) - 1;
+constexpr uint32_t MaterialMask = (1u << MaterialBits) - 1;
+constexpr uint32_t DepthMask = (1u << DepthBits) - 1;
+
+const char* layerNames[] = { "opaque", "sky", "translucent" };
+}
+
+RenderQueue::RenderQueue(GpuTimers& timers)
+    : timers(timers) {
+    for (size_t layer = 0; layer < layerTimers.size(); ++layer) {
+        layerTimers[layer] = timers.AddPass(layerNames[layer]);
+    }
+}
+
+void RenderQueue::Clear() {
+    packets.clear();
+    keys.clear();
+    triangles = 0;
+}
+
+uint32_t RenderQueue::programId(unsigned int program) {
+    auto found = programIds.emplace(program, static_cast<uint32_t>(programIds.size()));
+    return found.first->second & ProgramMask;
+}
+
+uint32_t RenderQueue::materialId(const DrawPacket& packet) {
+    uint64_t textures = static_cast<uint64_t>(packet.textures[0].bind ? packet.textures[0].texture : 0) << 32
+        | (packet.textures[1].bind ? packet.textures[1].texture : 0);
+    auto found = materialIds.emplace(textures, static_cast<uint32_t>(materialIds.size()));
+    return found.first->second & MaterialMask;
+}
+
+uint64_t RenderQueue::makeKey(RenderLayer layer, const DrawPacket& packet, float viewDepth) {
+    uint64_t depth = static_cast<uint64_t>(std::clamp(viewDepth / MaxDepth, 0.0f, 1.0f) * DepthMask);
+    uint64_t program = programId(packet.program);
+    uint64_t material = materialId(packet);
+
+    uint64_t key = static_cast<uint64_t>(layer) << LayerShift;
+    if (layer == RenderLayer::Translucent) {
+        key |= (DepthMask - depth) << (LayerShift - DepthBits);
+        key |= program << (LayerShift - DepthBits - ProgramBits);
+        key |= material << (LayerShift - DepthBits - ProgramBits - MaterialBits);
+    }
+    else {
+        key |= program << (LayerShift - ProgramBits);
+        key |= material << (LayerShift - ProgramBits - MaterialBits);
+        key |= depth << (LayerShift - ProgramBits - MaterialBits - DepthBits);
+    }
+    return key;
+}
+
+void RenderQueue::Submit(RenderLayer layer, const DrawPacket& packet, float viewDepth) {
+    keys.push_back(makeKey(layer, packet, viewDepth));
+    packets.push_back(packet);
+    triangles += packet.count / 3;
+}
+
+// LSD radix sort of (key, index) pairs, one byte per pass. Stable, so equal keys keep their
+// submission order. Bytes that are the same in every key (most of them, with a few hundred
+// packets) are skipped after the histogram.
+void RenderQueue::radixSort() {
+    size_t count = keys.size();
+    sorted.resize(count);
+    scratch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        sorted[i] = { keys[i], static_cast<uint32_t>(i) };
+    }
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {};
+        for (const auto& entry : sorted) {
+            ++histogram[(entry.first >> shift) & 0xFF];
+        }
+        if (histogram[(sorted[0].first >> shift) & 0xFF] == count) {
+            continue;
+        }
+        size_t offset = 0;
+        for (size_t& bucket : histogram) {
+            size_t size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (const auto& entry : sorted) {
+            scratch[histogram[(entry.first >> shift) & 0xFF]++] = entry;
+        }
+        sorted.swap(scratch);
+    }
+}
+
+int RenderQueue::Execute(GLState& state) {
+    PROFILE_SCOPE("Render queue");
+    if (packets.empty()) return 0;
+    {
+        PROFILE_SCOPE("Sort draw keys");
+        radixSort();
+    }
+
+    int currentLayer = -1;
+    for (const auto& [key, index] : sorted) {
+        int layer = static_cast<int>(key >> LayerShift);
+        if (layer != currentLayer) {
+            if (currentLayer >= 0) timers.End();
+            timers.Begin(layerTimers[layer]);
+            currentLayer = layer;
+
+            // Blending stays on everywhere, textures with alpha cut out their own shapes
+            state.SetDepthTest(true);
+            state.SetDepthFunc(layer == static_cast<int>(RenderLayer::Sky) ? GL_LEQUAL : GL_LESS);
+            state.SetBlend(true);
+            state.SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        const DrawPacket& packet = packets[index];
+        state.UseProgram(packet.program);
+        for (int unit = 0; unit < static_cast<int>(packet.textures.size()); ++unit) {
+            if (packet.textures[unit].bind) {
+                state.BindTexture(unit, packet.textures[unit].target, packet.textures[unit].texture);
+            }
+        }
+        if (packet.model) {
+            state.SetUniform("model", *packet.model);
+        }
+        state.BindVertexArray(packet.vertexArray);
+        if (packet.indexed) {
+            glDrawElements(GL_TRIANGLES, packet.count, GL_UNSIGNED_INT, 0);
+        }
+        else {
+            glDrawArrays(GL_TRIANGLES, 0, packet.count);
+        }
+    }
+    timers.End();
+    return static_cast<int>(sorted.size());
+}
@@ -0,0 +1,79 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "GLState.h"
+#include "GpuTimers.h"
+
+// Drawn in this order; each layer has a fixed depth/blend state and its own GPU timer
+enum class RenderLayer : uint8_t {
+    Opaque = 0,      // sorted by program, material, then front to back
+    Sky = 1,         // after the opaque geometry so it only fills what is left
+    Translucent = 2, // back to front
+    Count
+};
+
+// One draw. Per-frame uniforms are set on the program before the queue runs; a packet only carries
+// what differs between draws of the same program.
+struct DrawPacket {
+    unsigned int program = 0;
+    unsigned int vertexArray = 0;
+    GLsizei count = 0;
+    bool indexed = true;            // GL_UNSIGNED_INT indices from the VAO, GL_TRIANGLES either way
+    struct Texture {
+        GLenum target = GL_TEXTURE_2D;
+        unsigned int texture = 0;
+        bool bind = false;          // leave the unit as it is when false
+    };
+    std::array<Texture, 2> textures;
+    const glm::mat4* model = nullptr; // "model" uniform, must stay valid until Execute(); nullptr leaves it alone
+};
+
+// Draw packets submitted by every pass of a frame, sorted once and executed in one loop. Each
+// packet gets a 64-bit key (see makeKey) and the keys are radix sorted, so opaque draws are
+// grouped by program and material to minimize state changes, and translucent ones are drawn
+// back to front. Must only be used on the thread that holds the GL context.
+class RenderQueue {
+public:
+    // Queries for the layers are added to timers
+    explicit RenderQueue(GpuTimers& timers);
+
+    // Empties the queue for a new frame
+    void Clear();
+    // viewDepth is the distance along the view direction, clamped to [0, MaxDepth]
+    void Submit(RenderLayer layer, const DrawPacket& packet, float viewDepth);
+
+    // Sorts and draws everything submitted since Clear(), returns the number of draw calls
+    int Execute(GLState& state);
+
+    size_t GetPacketCount() const { return packets.size(); }
+    size_t GetSubmittedTriangleCount() const { return triangles; }
+
+    static constexpr float MaxDepth = 100.0f; // the far plane
+
+private:
+    uint64_t makeKey(RenderLayer layer, const DrawPacket& packet, float viewDepth);
+    // Small stable ids, assigned on first sight, so the key fields stay narrow
+    uint32_t programId(unsigned int program);
+    uint32_t materialId(const DrawPacket& packet);
+    void radixSort();
+
+    GpuTimers& timers;
+    std::array<int, static_cast<size_t>(RenderLayer::Count)> layerTimers;
+
+    std::vector<DrawPacket> packets;
+    std::vector<uint64_t> keys;
+    size_t triangles = 0;
+    // Sort scratch: (key, packet index) pairs, ping-ponged between radix passes
+    std::vector<std::pair<uint64_t, uint32_t>> sorted, scratch;
+
+    std::unordered_map<unsigned int, uint32_t> programIds;
+    std::unordered_map<uint64_t, uint32_t> materialIds;
+};
+
+#endif
@@ -0,0 +1,505 @@
+#include "Renderer.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include "stb_image.h"
+#include "GLExtensions.h"
+#include "Profiler.h"
+
+// Compiles and links a vertex and fragment shader into an OpenGL shader program, or restores the
+// binary linked by an earlier run
+static unsigned int createShaderProgram(const std::string& vertexSource, const std::string& fragmentSource, ProgramCache& cache) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedMs = [&start] { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+    if (unsigned int cached = cache.Load(vertexSource, fragmentSource)) {
+        std::cout << "[ProgramCache] Restored program in " << elapsedMs() << " ms" << std::endl;
+        return cached;
+    }
+
+    auto compileShader = [](GLenum type, const char* source) -> unsigned int {
+        unsigned int shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        int success;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+        if (!success) {
+            char infoLog[512];
+            glGetShaderInfoLog(shader, 512, nullptr, infoLog);
+            std::cerr << "Shader Compilation Failed\n" << infoLog << std::endl;
+        }
+        return shader;
+        };
+
+    unsigned int vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource.c_str());
+    unsigned int fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource.c_str());
+
+    unsigned int program = glCreateProgram();
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    cache.PrepareLink(program);
+    glLinkProgram(program);
+    int linked;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        std::cerr << "Shader Linking Failed\n" << infoLog << std::endl;
+    }
+
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    cache.Store(program, vertexSource, fragmentSource);
+    std::cout << "[ProgramCache] Compiled program in " << elapsedMs() << " ms" << std::endl;
+    return program;
+}
+
+// Builds the program once both sources have been read by the asset manager
+template <typename Sources>
+static bool compileWhenReady(Sources& sources, unsigned int& program, ProgramCache& cache) {
+    if (program || !AssetManager::IsReady(sources.vertex) || !AssetManager::IsReady(sources.fragment)) {
+        return false;
+    }
+    program = createShaderProgram(*sources.vertex.get(), *sources.fragment.get(), cache);
+    sources = Sources();
+    return true;
+}
+
+// ----- Load the Cube Map for the Skybox ----- //
+
+static unsigned int loadCubemap(const std::vector<AssetFuture<ImageData>>& faces, std::vector<TrackedMemory>& memory) {
+    unsigned int texID;
+    size_t bytes = 0;
+    int faceWidth = 0, faceHeight = 0;
+    glGenTextures(1, &texID);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, texID);
+
+    // The faces are stored sRGB encoded, the scene renders in linear light
+    for (unsigned int i = 0; i < faces.size(); i++) {
+        std::shared_ptr<const ImageData> face = faces[i].get();
+        if (face->Valid()) {
+            glTexImage2D(
+                GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_SRGB8, face->width, face->height, 0, GL_RGB, GL_UNSIGNED_BYTE, face->pixels.data()
+            );
+            bytes += MemoryTracker::TextureLevelBytes(GL_SRGB8, face->width, face->height);
+            faceWidth = face->width;
+            faceHeight = face->height;
+        }
+    }
+    memory.emplace_back(MemoryCategory::Textures, "skybox", "cubemap, 6 faces of " + std::to_string(faceWidth) + "x"
+        + std::to_string(faceHeight), MemoryTracker::FormatName(GL_SRGB8), bytes);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    return texID;
+}
+
+// ----- Creates the Skybox VAO ----- //
+
+static unsigned int createSkyboxVAO(std::vector<TrackedMemory>& memory) {
+    float skyboxVertices[] = {
+        -1.0f,  1.0f, -1.0f,  -1.0f, -1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
+         1.0f, -1.0f, -1.0f,   1.0f,  1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+
+        -1.0f, -1.0f,  1.0f,  -1.0f, -1.0f, -1.0f, -1.0f,  1.0f, -1.0f,
+        -1.0f,  1.0f, -1.0f, -1.0f,  1.0f,  1.0f, -1.0f, -1.0f,  1.0f,
+
+         1.0f, -1.0f, -1.0f,   1.0f, -1.0f,  1.0f,  1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,   1.0f,  1.0f, -1.0f,  1.0f, -1.0f, -1.0f,
+
+        -1.0f, -1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,   1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,   1.0f, -1.0f,  1.0f,  -1.0f, -1.0f,  1.0f,
+
+        -1.0f,  1.0f, -1.0f,   1.0f,  1.0f, -1.0f,   1.0f,  1.0f,  1.0f,
+         1.0f,  1.0f,  1.0f,  -1.0f,  1.0f,  1.0f,  -1.0f,  1.0f, -1.0f,
+
+        -1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f, -1.0f,
+         1.0f, -1.0f, -1.0f,  -1.0f, -1.0f,  1.0f,   1.0f, -1.0f,  1.0f
+    };
+    unsigned int skyboxVAO, skyboxVBO;
+    glGenVertexArrays(1, &skyboxVAO);
+    glGenBuffers(1, &skyboxVBO);
+    glBindVertexArray(skyboxVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, skyboxVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(skyboxVertices), &skyboxVertices, GL_STATIC_DRAW);
+    memory.emplace_back(MemoryCategory::Geometry, "skybox", "vertex buffer", "vec3", sizeof(skyboxVertices));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    return skyboxVAO;
+}
+
+Renderer::Renderer(const std::filesystem::path& assetRoot, AssetManager& assets, AssetFuture<ModelData> modelFuture,
+    JobSystem& jobs, std::chrono::steady_clock::time_point startTime)
+    : assets(assets), jobs(jobs), startTime(startTime), modelFuture(modelFuture), programCache("shader_cache"),
+    shaderVariants([this](const std::string& vertexSource, const std::string& fragmentSource) {
+        return createShaderProgram(vertexSource, fragmentSource, programCache);
+        }),
+    renderQueue(gpuTimers), streamBuffer(GL_UNIFORM_BUFFER, 64 * 1024, "frame uniforms"), postProcess(gpuTimers) {
+    // ----- This code segment right here creates a plane below the carousel ----- //
+    float groundSize = 50.0f;
+    float repeat = 25.0f;
+    float groundVertices[] = {
+        // positions          // texCoords
+        -groundSize, 0.0f, -groundSize,  0.0f,      0.0f,
+         groundSize, 0.0f, -groundSize,  repeat,    0.0f,
+         groundSize, 0.0f,  groundSize,  repeat,    repeat,
+        -groundSize, 0.0f,  groundSize,  0.0f,      repeat
+    };
+    unsigned int groundIndices[] = {
+        0, 1, 2,
+        2, 3, 0
+    };
+
+    unsigned int groundVBO, groundEBO;
+    glGenVertexArrays(1, &groundVAO);
+    glGenBuffers(1, &groundVBO);
+    glGenBuffers(1, &groundEBO);
+
+    glBindVertexArray(groundVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, groundVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(groundVertices), groundVertices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, groundEBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(groundIndices), groundIndices, GL_STATIC_DRAW);
+    memory.emplace_back(MemoryCategory::Geometry, "ground", "vertex buffer", "vec3+vec2", sizeof(groundVertices));
+    memory.emplace_back(MemoryCategory::Geometry, "ground", "index buffer", "uint32", sizeof(groundIndices));
+
+    // position
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    // texCoords
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+    glEnableVertexAttribArray(1);
+
+    glBindVertexArray(0);
+
+    // ----- End of Segment ----- //
+
+    // Setup Skybox VAO, the cubemap is created once all faces are decoded
+    skyboxVAO = createSkyboxVAO(memory);
+
+    // The render queue times its layers (opaque, sky, translucent) itself
+    uploadPass = gpuTimers.AddPass("uploads");
+    hudPass = gpuTimers.AddPass("hud");
+
+    // ----- Queue asset loads, shaders first, then what the first frames show ----- //
+    std::filesystem::path shaderBase = assetRoot / "shaders";
+    auto loadSources = [&](const std::string& name) {
+        return ShaderSources{
+            assets.LoadText(shaderBase / (name + ".vs"), AssetPriority::Critical),
+            assets.LoadText(shaderBase / (name + ".fs"), AssetPriority::Critical) };
+        };
+    skyboxSources = loadSources("skybox");
+    groundSources = loadSources("ground");
+    shaderSources = loadSources("shader");
+    hudSources = loadSources("hud");
+    // The post chain's fragment shaders share the full-screen triangle
+    auto loadPostSources = [&](const std::string& name) {
+        return ShaderSources{
+            assets.LoadText(shaderBase / "post.vs", AssetPriority::Critical),
+            assets.LoadText(shaderBase / (name + ".fs"), AssetPriority::Critical) };
+        };
+    bloomDownSources = loadPostSources("bloom_down");
+    bloomUpSources = loadPostSources("bloom_up");
+    tonemapSources = loadPostSources("tonemap");
+
+    std::filesystem::path skyboxPath = assetRoot / "skybox";
+    for (const char* face : { "skybox_right.png", "skybox_left.png", "skybox_top.png",
+                              "skybox_bottom.png", "skybox_front.png", "skybox_back.png" }) {
+        skyboxFaces.push_back(assets.LoadImage(skyboxPath / face, AssetPriority::High, 3));
+    }
+    groundImage = assets.LoadTexture(assetRoot / "textures" / "ground.jpg", AssetPriority::High,
+        HasGLExtension("GL_EXT_texture_compression_s3tc"));
+}
+
+double Renderer::millisecondsSinceStart() const {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+// Turns every finished background load into GL objects
+void Renderer::pollAssets() {
+    PROFILE_SCOPE("Poll assets");
+    compileWhenReady(skyboxSources, skbShader, programCache);
+    compileWhenReady(groundSources, groundShader, programCache);
+    if (!shaderVariants.HasSources() && AssetManager::IsReady(shaderSources.vertex) && AssetManager::IsReady(shaderSources.fragment)) {
+        shaderVariants.SetSources(*shaderSources.vertex.get(), *shaderSources.fragment.get());
+        shaderSources = ShaderSources();
+    }
+    compileWhenReady(hudSources, hudShader, programCache);
+    compileWhenReady(bloomDownSources, bloomDownShader, programCache);
+    compileWhenReady(bloomUpSources, bloomUpShader, programCache);
+    compileWhenReady(tonemapSources, tonemapShader, programCache);
+    if (!postProcess.HasPrograms() && bloomDownShader && bloomUpShader && tonemapShader) {
+        postProcess.SetPrograms(bloomDownShader, bloomUpShader, tonemapShader);
+    }
+
+    // ----- Load Ground Texture Segment ----- //
+    if (AssetManager::IsReady(groundImage)) {
+        groundTex = textureStreamer.Enqueue(groundImage.get(), GL_REPEAT, true, "ground", "ground.jpg");
+        groundImage = AssetFuture<ImageData>();
+    }
+
+    // ----- Skybox cubemap, once all six faces are in ----- //
+    if (!skyboxFaces.empty() && std::all_of(skyboxFaces.begin(), skyboxFaces.end(),
+        [](const AssetFuture<ImageData>& face) { return AssetManager::IsReady(face); })) {
+        cubemapTex = loadCubemap(skyboxFaces, memory);
+        skyboxFaces.clear();
+    }
+
+    // ----- Carousel model ----- //
+    if (AssetManager::IsReady(modelFuture)) {
+        model = std::make_unique<ModelLoader>(*modelFuture.get(), jobs, textureStreamer);
+        modelFuture = AssetFuture<ModelData>();
+
+        variantsWarm = false;
+        loadTimes.carouselMs = millisecondsSinceStart();
+        std::cout << "[Startup] Carousel resident after " << loadTimes.carouselMs << " ms" << std::endl;
+    }
+
+    // Compile the carousel's variants now rather than on the frame that first draws them: before the
+    // simulation places the bulbs (no lights) and after
+    if (model && shaderVariants.HasSources() && !variantsWarm) {
+        for (uint32_t features : model->GetFeatureSets()) {
+            shaderVariants.Get(features, 0);
+            shaderVariants.Get(features, static_cast<int>(model->GetBulbPositions().size()));
+        }
+        variantsWarm = true;
+    }
+
+    // Spread pending texture uploads over frames instead of stalling this one
+    {
+        GpuTimers::Scope gpuScope(gpuTimers, uploadPass);
+        textureStreamer.Update();
+    }
+
+    if (loadTimes.environmentMs < 0.0 && groundTex && cubemapTex && groundShader && skbShader) {
+        loadTimes.environmentMs = millisecondsSinceStart();
+        std::cout << "[Startup] Ground and skybox resident after " << loadTimes.environmentMs << " ms" << std::endl;
+    }
+}
+
+void Renderer::FramePresented() {
+    if (loadTimes.firstFrameMs < 0.0) {
+        loadTimes.firstFrameMs = millisecondsSinceStart();
+        std::cout << "[Startup] First frame presented after " << loadTimes.firstFrameMs << " ms" << std::endl;
+    }
+}
+
+// PointLight of ground.fs/shader.fs laid out for std140: every vec3 starts a 16-byte slot, the
+// float after the last one fills its gap
+struct PointLightStd140 {
+    glm::vec3 position;
+    float padding0;
+    glm::vec3 ambient;
+    float padding1;
+    glm::vec3 diffuse;
+    float padding2;
+    glm::vec3 specular;
+    float constant;
+    float linear, quadratic;
+    float padding3[2];
+};
+static_assert(sizeof(PointLightStd140) == 80, "std140 array stride of PointLight");
+
+// Writes the warm carousel bulb lights of this frame into a PointLightBlock of slotCount entries in the
+// stream buffer and binds it. Slots past the frame's lights are black lights far away, for shaders with
+// a fixed light count. One block serves every program bound to the binding.
+void Renderer::uploadPointLights(GLuint binding, const FrameSnapshot& frame, float linear, float quadratic, int slotCount) {
+    PROFILE_SCOPE("Point light block");
+    StreamBuffer::Allocation block = streamBuffer.Allocate(slotCount * sizeof(PointLightStd140));
+    if (!block.data) return;
+
+    PointLightStd140* lights = reinterpret_cast<PointLightStd140*>(block.data);
+    for (int i = 0; i < slotCount; ++i) {
+        bool lit = i < frame.numLights;
+        PointLightStd140 light = {};
+        light.position = lit ? frame.lightPositions[i] : glm::vec3(0.0f, -1000.0f, 0.0f);
+        light.ambient = lit ? glm::vec3(0.4f, 0.2f, 0.1f) : glm::vec3(0.0f);
+        light.diffuse = lit ? glm::vec3(1.8f, 1.0f, 0.6f) : glm::vec3(0.0f);
+        light.specular = lit ? glm::vec3(2.0f, 1.6f, 1.0f) : glm::vec3(0.0f);
+        light.constant = 1.0f;
+        light.linear = linear;
+        light.quadratic = quadratic;
+        lights[i] = light; // whole entries only, the mapping is write-only
+    }
+    glState.BindUniformBuffer(binding, streamBuffer.GetBuffer(), block.offset, block.size);
+}
+
+void Renderer::SetFrameTimeTarget(double targetMs) {
+    if (targetMs > 0.0) {
+        dynamicResolution = std::make_unique<DynamicResolution>(targetMs);
+    }
+    else {
+        dynamicResolution.reset();
+        postProcess.SetRenderScale(1.0f);
+    }
+}
+
+FrameCapture& Renderer::EnableCapture(const CaptureOptions& options) {
+    capture = std::make_unique<FrameCapture>(gpuTimers, options);
+    return *capture;
+}
+
+void Renderer::RenderFrame(const FrameSnapshot& frame, int width, int height) {
+    PROFILE_SCOPE("RenderFrame");
+    gpuTimers.BeginFrame();
+    if (dynamicResolution) {
+        // A frame with a pass still in flight would read as too fast
+        bool measured = gpuTimers.IsLastFrameComplete() && gpuTimers.GetLastFrameMs() > 0.0;
+        postProcess.SetRenderScale(dynamicResolution->Update(measured ? gpuTimers.GetLastFrameMs() : 0.0));
+    }
+    glState.BeginFrame();
+    streamBuffer.BeginFrame();
+    // Uploads and VAO setup bind behind the tracker's back until everything is resident
+    bool loading = !IsFullyLoaded();
+    pollAssets();
+    if (loading) glState.Invalidate();
+    hud.RecordFrame();
+    stats = RenderStats();
+    stats.renderScale = postProcess.GetRenderScale();
+    if (width <= 0 || height <= 0) return; // minimized
+
+    // The scene renders in linear HDR, Resolve() below writes the output framebuffer
+    if (postProcess.Resize(width, height)) glState.Invalidate();
+    postProcess.BeginScene();
+
+    const glm::mat4& view = frame.view;
+    float aspectRatio = static_cast<float>(width) / static_cast<float>(height); // of the output, whatever the scale
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), aspectRatio, 0.1f, 100.0f);
+
+    glClearColor(0.010f, 0.010f, 0.019f, 1.0f); // (0.1, 0.1, 0.15) in sRGB
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // ----- Each pass sets its frame uniforms and queues its draws, the queue sorts and runs them ----- //
+    renderQueue.Clear();
+    float originDepth = -(view * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)).z; // the ground is centered there
+
+    // ----- Ground -----
+    if (groundShader && groundTex) {
+        PROFILE_SCOPE("Ground");
+        glState.UseProgram(groundShader);
+        glState.SetUniform("viewPos", frame.cameraPos);
+        glState.SetUniform("view", view);
+        glState.SetUniform("projection", projection);
+
+        // The ground shader loops over numPointLights of its MaxPointLights slots
+        glState.SetUniformBlockBinding("PointLightBlock", GroundLightsBinding);
+        glState.SetUniform("numPointLights", frame.numLights);
+        uploadPointLights(GroundLightsBinding, frame, 0.14f, 0.07f, MaxPointLights);
+
+        // Ground texture on unit 0, fake normal map (nothing bound) on unit 1
+        glState.SetUniform("diffuseMap", 0);
+        glState.SetUniform("normalMap", 1);
+
+        // Force shader to not use emissive lightbulb override
+        glState.SetUniform("forceBulbColor", 0);
+
+        DrawPacket packet;
+        packet.program = groundShader;
+        packet.vertexArray = groundVAO;
+        packet.count = 6;
+        packet.textures[0] = { GL_TEXTURE_2D, groundTex, true };
+        packet.textures[1] = { GL_TEXTURE_2D, 0, true };
+        packet.model = &groundModel;
+        renderQueue.Submit(RenderLayer::Opaque, packet, originDepth);
+    }
+
+    // --- Skybox, depth test LEQUAL so it passes at the far plane ---
+    if (skbShader && cubemapTex) {
+        PROFILE_SCOPE("Skybox");
+        glState.UseProgram(skbShader);
+
+        // Remove translation from view matrix
+        glm::mat4 viewNoTranslation = glm::mat4(glm::mat3(view));
+        glState.SetUniform("view", viewNoTranslation);
+        glState.SetUniform("projection", projection);
+        glState.SetUniform("skybox", 0);
+
+        DrawPacket packet;
+        packet.program = skbShader;
+        packet.vertexArray = skyboxVAO;
+        packet.count = 36;
+        packet.indexed = false;
+        packet.textures[0] = { GL_TEXTURE_CUBE_MAP, cubemapTex, true };
+        renderQueue.Submit(RenderLayer::Sky, packet, RenderQueue::MaxDepth);
+    }
+
+    // ----- Carousel once its meshes are resident ----- //
+    if (shaderVariants.HasSources() && model) {
+        PROFILE_SCOPE("Carousel");
+
+        // Frame uniforms go to every variant the model uses, its packets then only carry the model matrix
+        int lightCount = LightCountBucket(frame.numLights);
+        if (lightCount > 0) {
+            uploadPointLights(CarouselLightsBinding, frame, 0.045f, 0.0075f, lightCount);
+        }
+        variantPrograms.clear();
+        for (uint32_t features : model->GetFeatureSets()) {
+            unsigned int program = shaderVariants.Get(features, lightCount);
+            variantPrograms.push_back(program);
+            glState.UseProgram(program);
+
+            // Set camera position for lighting calculations
+            glState.SetUniform("viewPos", frame.cameraPos);
+
+            // Warm carousel bulb lights, bulbs themselves are not lit
+            if (!(features & ShaderFeatureBulbEmissive)) {
+                glState.SetUniformBlockBinding("PointLightBlock", CarouselLightsBinding);
+            }
+
+            glState.SetUniform("time", frame.time);
+            glState.SetUniform("view", view);
+            glState.SetUniform("projection", projection);
+            glState.SetUniform("diffuseMap", 0);
+            glState.SetUniform("normalMap", 1);
+        }
+
+        model->Submit(frame.meshTransforms, variantPrograms, view, projection, renderQueue);
+        stats.culledMeshes = model->GetCulledMeshCount();
+    }
+
+    streamBuffer.Flush();
+    stats.drawCalls = renderQueue.Execute(glState);
+    stats.triangles = renderQueue.GetSubmittedTriangleCount();
+    postProcess.Resolve(glState, outputFramebuffer);
+    if (capture) capture->Capture(outputFramebuffer, width, height);
+
+    // ----- Performance overlay, drawn last over the scene and not counted in its stats ----- //
+    if (frame.showHud && hudShader) {
+        PROFILE_SCOPE("HUD");
+        GpuTimers::Scope gpuScope(gpuTimers, hudPass);
+        HudValues values;
+        values.drawCalls = stats.drawCalls;
+        values.triangles = stats.triangles;
+        values.culledMeshes = stats.culledMeshes;
+        values.bulbs = frame.numLights;
+        values.gpuMs = gpuTimers.GetAverageTotalMs();
+        values.hudGpuMs = gpuTimers.GetAverageMs(hudPass);
+        values.firstFrameMs = loadTimes.firstFrameMs;
+        values.environmentMs = loadTimes.environmentMs;
+        values.carouselMs = loadTimes.carouselMs;
+        values.glIssued = glState.GetLastFrameCounters().issued;
+        values.glElided = glState.GetLastFrameCounters().elided;
+        values.postGpuMs = postProcess.GetAverageMs();
+        values.postBudgetMs = PostProcess::BudgetMs;
+        values.renderScale = postProcess.GetRenderScale();
+        values.renderWidth = postProcess.GetRenderWidth();
+        values.renderHeight = postProcess.GetRenderHeight();
+        values.frameTargetMs = dynamicResolution ? dynamicResolution->GetTargetMs() : 0.0;
+        if (capture) {
+            values.capturedFrames = capture->GetCapturedCount();
+            values.droppedFrames = capture->GetDroppedCount();
+            values.captureCpuMs = capture->GetLastCpuMs();
+            values.captureGpuMs = capture->GetAverageGpuMs();
+        }
+        MemoryTotals memoryTotals = MemoryTracker::GetTotals();
+        values.gpuMemoryBytes = memoryTotals.gpuBytes;
+        values.cpuMemoryBytes = memoryTotals.cpuBytes;
+        hud.Draw(glState, hudShader, values, width, height);
+    }
+    streamBuffer.EndFrame();
+}
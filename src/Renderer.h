@@ -0,0 +1,126 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "AssetManager.h"
+#include "FrameSnapshot.h"
+#include "GLState.h"
+#include "GpuTimers.h"
+#include "Hud.h"
+#include "JobSystem.h"
+#include "DynamicResolution.h"
+#include "FrameCapture.h"
+#include "MemoryTracker.h"
+#include "ModelLoader.h"
+#include "PostProcess.h"
+#include "ProgramCache.h"
+#include "RenderQueue.h"
+#include "ShaderVariants.h"
+#include "StreamBuffer.h"
+#include "TextureStreamer.h"
+
+// Milliseconds since startup, -1 until the milestone is reached
+struct LoadTimes {
+    double firstFrameMs = -1.0;
+    double environmentMs = -1.0; // ground and skybox resident
+    double carouselMs = -1.0;    // model uploaded and drawable
+};
+
+// What the last RenderFrame submitted
+struct RenderStats {
+    int drawCalls = 0;
+    size_t triangles = 0;
+    size_t culledMeshes = 0;
+    float renderScale = 1.0f; // of the scene, see PostProcess::SetRenderScale
+};
+
+// Owns every GL resource of the scene and draws one FrameSnapshot per call. Assets arrive
+// asynchronously: each pass is skipped until its shaders and textures are resident, so the first
+// frame presents immediately and the scene fills in (skybox/ground first, then the carousel).
+// Must only be used on the thread that holds the GL context.
+class Renderer {
+public:
+    Renderer(const std::filesystem::path& assetRoot, AssetManager& assets, AssetFuture<ModelData> modelFuture,
+        JobSystem& jobs, std::chrono::steady_clock::time_point startTime);
+    void RenderFrame(const FrameSnapshot& frame, int width, int height);
+    // Call after the swap so time-to-first-frame includes presentation
+    void FramePresented();
+
+    // Frames are drawn into this framebuffer, 0 (the default) unless running headless
+    void SetOutputFramebuffer(unsigned int framebuffer) { outputFramebuffer = framebuffer; }
+    // Scales the scene resolution to keep the GPU frame time near targetMs, <= 0 renders at full
+    // resolution. Off until set.
+    void SetFrameTimeTarget(double targetMs);
+    // Null while the scene renders at full resolution
+    const DynamicResolution* GetDynamicResolution() const { return dynamicResolution.get(); }
+    // Reads every frame back after the post chain, before the HUD, so captures show only the scene
+    FrameCapture& EnableCapture(const CaptureOptions& options);
+    // Null until EnableCapture()
+    FrameCapture* GetCapture() { return capture.get(); }
+    const FrameCapture* GetCapture() const { return capture.get(); }
+
+    const LoadTimes& GetLoadTimes() const { return loadTimes; }
+    const RenderStats& GetLastFrameStats() const { return stats; }
+    // Per-pass GPU time (render queue layers, texture uploads, bloom, tonemap, hud)
+    const GpuTimers& GetGpuTimers() const { return gpuTimers; }
+    // GL calls of the last complete frame that reached the driver or were skipped as redundant
+    const GLStateCounters& GetGLStateCounters() const { return glState.GetLastFrameCounters(); }
+    const PostProcess& GetPostProcess() const { return postProcess; }
+    bool IsCarouselResident() const { return model != nullptr; }
+    // Every queued asset is on the GPU, nothing left to stream
+    bool IsFullyLoaded() const { return model && loadTimes.environmentMs >= 0.0 && textureStreamer.IsIdle(); }
+
+private:
+    struct ShaderSources {
+        AssetFuture<std::string> vertex, fragment;
+    };
+
+    void pollAssets();
+    // Uniform buffer bindings of the PointLightBlock in ground.fs and the lit shader.fs variants
+    static constexpr GLuint GroundLightsBinding = 0, CarouselLightsBinding = 1;
+    void uploadPointLights(GLuint binding, const FrameSnapshot& frame, float linear, float quadratic, int slotCount);
+    double millisecondsSinceStart() const;
+
+    AssetManager& assets;
+    JobSystem& jobs;
+    std::chrono::steady_clock::time_point startTime;
+    LoadTimes loadTimes;
+    RenderStats stats;
+
+    // Pending loads, reset once consumed
+    AssetFuture<ModelData> modelFuture;
+    ShaderSources shaderSources, groundSources, skyboxSources, hudSources;
+    ShaderSources bloomDownSources, bloomUpSources, tonemapSources;
+    AssetFuture<ImageData> groundImage;
+    std::vector<AssetFuture<ImageData>> skyboxFaces;
+
+    TextureStreamer textureStreamer;
+    ProgramCache programCache;
+    ShaderVariants shaderVariants; // carousel programs (shader.vs/shader.fs) per mesh feature set
+    std::vector<unsigned int> variantPrograms;
+    bool variantsWarm = false;
+    GpuTimers gpuTimers;
+    GLState glState;
+    RenderQueue renderQueue; // after gpuTimers, it adds its layer passes on construction
+    StreamBuffer streamBuffer; // per-frame uniform blocks
+    PostProcess postProcess;   // HDR scene target, bloom and tonemap
+    std::unique_ptr<DynamicResolution> dynamicResolution;
+    std::unique_ptr<FrameCapture> capture;
+    int uploadPass, hudPass;
+    Hud hud;
+    std::unique_ptr<ModelLoader> model;
+    unsigned int groundShader = 0, skbShader = 0, hudShader = 0;
+    unsigned int bloomDownShader = 0, bloomUpShader = 0, tonemapShader = 0;
+    unsigned int groundVAO = 0, skyboxVAO = 0;
+    glm::mat4 groundModel = glm::mat4(1.0f);
+    unsigned int groundTex = 0, cubemapTex = 0;
+    std::vector<TrackedMemory> memory; // ground and skybox buffers and the cubemap
+    unsigned int outputFramebuffer = 0;
+};
+
+#endif
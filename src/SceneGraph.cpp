@@ -0,0 +1,81 @@
+#include "SceneGraph.h"
+#include <algorithm>
+#include "Profiler.h"
+
+SceneGraph::NodeId SceneGraph::AddNode(const std::string& name, NodeId parent, const glm::mat4& local) {
+    NodeId node = static_cast<NodeId>(parents.size());
+    parents.push_back(parent);
+    depths.push_back(parent == NoNode ? 0 : depths[parent] + 1);
+    locals.push_back(local);
+    worlds.push_back(local);
+    dirty.push_back(1);
+    names.push_back(name);
+    anyDirty = true;
+    levelsStale = true;
+    return node;
+}
+
+void SceneGraph::SetLocal(NodeId node, const glm::mat4& local) {
+    locals[node] = local;
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+SceneGraph::NodeId SceneGraph::Find(const std::string& name) const {
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (names[i] == name) return static_cast<NodeId>(i);
+    }
+    return NoNode;
+}
+
+// Counting sort of the ids by depth, stable so a level keeps the id order
+void SceneGraph::buildLevels() {
+    uint32_t levelCount = 0;
+    for (uint32_t depth : depths) {
+        levelCount = std::max(levelCount, depth + 1);
+    }
+    levelStarts.assign(levelCount + 1, 0);
+    for (uint32_t depth : depths) {
+        ++levelStarts[depth + 1];
+    }
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        levelStarts[level + 1] += levelStarts[level];
+    }
+
+    std::vector<size_t> next(levelStarts.begin(), levelStarts.end() - 1);
+    levelOrder.resize(parents.size());
+    for (size_t i = 0; i < parents.size(); ++i) {
+        levelOrder[next[depths[i]]++] = static_cast<NodeId>(i);
+    }
+    levelsStale = false;
+}
+
+size_t SceneGraph::Update(JobSystem& jobs) {
+    if (!anyDirty) return 0;
+    PROFILE_SCOPE("Scene graph update");
+    if (levelsStale) buildLevels();
+
+    // Parents come first, so one pass hands a dirty flag down the whole subtree
+    size_t updated = 0;
+    for (size_t i = 0; i < parents.size(); ++i) {
+        if (parents[i] != NoNode) dirty[i] |= dirty[parents[i]];
+        updated += dirty[i];
+    }
+
+    // A level only reads the world matrices of the one above, which is complete
+    for (size_t level = 0; level + 1 < levelStarts.size(); ++level) {
+        size_t begin = levelStarts[level];
+        jobs.ParallelFor(levelStarts[level + 1] - begin, ParallelGrain, [&](size_t first, size_t last) {
+            for (size_t i = begin + first; i < begin + last; ++i) {
+                NodeId node = levelOrder[i];
+                if (!dirty[node]) continue;
+                NodeId parent = parents[node];
+                worlds[node] = parent == NoNode ? locals[node] : worlds[parent] * locals[node];
+            }
+            });
+    }
+
+    std::fill(dirty.begin(), dirty.end(), uint8_t(0));
+    anyDirty = false;
+    return updated;
+}
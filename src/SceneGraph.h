@@ -0,0 +1,64 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "JobSystem.h"
+
+// One node of an imported hierarchy (e.g. the glTF nodes), listed parents first
+struct SceneNodeData {
+    std::string name;
+    int parent = -1; // index into the same list, -1 for a root
+    glm::mat4 local = glm::mat4(1.0f);
+    std::vector<unsigned int> meshes;
+};
+
+// Flat transform hierarchy in structure-of-arrays layout. A node can only be added under an
+// existing one, so ids are a topological order (parents before children) and a single forward
+// pass propagates the dirty flags. World matrices are then recomputed depth level by depth level,
+// each level split across the job system, and only for nodes whose local transform or an
+// ancestor's changed since the last Update().
+class SceneGraph {
+public:
+    using NodeId = uint32_t;
+    static constexpr NodeId NoNode = ~0u;
+
+    // parent must be an existing node or NoNode for a root
+    NodeId AddNode(const std::string& name, NodeId parent, const glm::mat4& local);
+    void SetLocal(NodeId node, const glm::mat4& local);
+    // First node with this name, NoNode if there is none
+    NodeId Find(const std::string& name) const;
+
+    // Recomputes the world matrices of the dirty subtrees, returns how many were recomputed
+    size_t Update(JobSystem& jobs);
+
+    size_t GetNodeCount() const { return parents.size(); }
+    NodeId GetParent(NodeId node) const { return parents[node]; }
+    const std::string& GetName(NodeId node) const { return names[node]; }
+    const glm::mat4& GetLocal(NodeId node) const { return locals[node]; }
+    // As of the last Update()
+    const glm::mat4& GetWorld(NodeId node) const { return worlds[node]; }
+
+    // Levels with at least this many nodes are updated in parallel
+    static constexpr size_t ParallelGrain = 256;
+
+private:
+    void buildLevels();
+
+    std::vector<NodeId> parents;
+    std::vector<uint32_t> depths;
+    std::vector<glm::mat4> locals;
+    std::vector<glm::mat4> worlds;
+    std::vector<uint8_t> dirty;
+    std::vector<std::string> names;
+    bool anyDirty = false;
+
+    // Node ids ordered by depth; level d is [levelStarts[d], levelStarts[d + 1]). Rebuilt after AddNode().
+    std::vector<NodeId> levelOrder;
+    std::vector<size_t> levelStarts;
+    bool levelsStale = false;
+};
+
+#endif
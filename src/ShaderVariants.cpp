@@ -0,0 +1,61 @@
+#include "ShaderVariants.h"
+#include <algorithm>
+#include <iostream>
+#include <glad/glad.h>
+#include "FrameSnapshot.h"
+
+int LightCountBucket(int numLights) {
+    int clamped = std::min(std::max(numLights, 0), MaxPointLights);
+    return (clamped + LightBucketSize - 1) / LightBucketSize * LightBucketSize;
+}
+
+ShaderVariants::ShaderVariants(CompileFunction compile)
+    : compile(std::move(compile)) {}
+
+ShaderVariants::~ShaderVariants() {
+    for (const auto& variant : programs) {
+        glDeleteProgram(variant.second);
+    }
+}
+
+void ShaderVariants::SetSources(std::string vertex, std::string fragment) {
+    vertexSource = std::move(vertex);
+    fragmentSource = std::move(fragment);
+}
+
+uint32_t ShaderVariants::normalize(uint32_t features, int& lightCount) {
+    if (features & ShaderFeatureBulbEmissive) {
+        lightCount = 0;
+        return ShaderFeatureBulbEmissive;
+    }
+    lightCount = LightCountBucket(lightCount);
+    return features;
+}
+
+// The defines have to follow #version, which must stay the first line
+std::string ShaderVariants::withDefines(const std::string& source, const std::string& defines) {
+    size_t versionLine = source.find("#version");
+    size_t insertAt = versionLine == std::string::npos ? 0 : source.find('\n', versionLine);
+    insertAt = insertAt == std::string::npos ? source.size() : insertAt + 1;
+    return source.substr(0, insertAt) + defines + source.substr(insertAt);
+}
+
+unsigned int ShaderVariants::Get(uint32_t features, int lightCount) {
+    features = normalize(features, lightCount);
+    uint32_t key = features | static_cast<uint32_t>(lightCount) << 16;
+    auto found = programs.find(key);
+    if (found != programs.end()) {
+        return found->second;
+    }
+
+    std::string defines;
+    if (features & ShaderFeatureBulbEmissive) defines += "#define BULB_EMISSIVE\n";
+    if (features & ShaderFeatureNormalMap) defines += "#define NORMAL_MAP\n";
+    defines += "#define LIGHT_COUNT " + std::to_string(lightCount) + "\n";
+
+    unsigned int program = compile(withDefines(vertexSource, defines), withDefines(fragmentSource, defines));
+    std::cout << "[Shaders] Variant" << (features & ShaderFeatureBulbEmissive ? " BULB_EMISSIVE" : "")
+        << (features & ShaderFeatureNormalMap ? " NORMAL_MAP" : "") << " LIGHT_COUNT=" << lightCount << " ready" << std::endl;
+    programs[key] = program;
+    return program;
+}
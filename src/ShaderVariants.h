@@ -0,0 +1,51 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+// Features of shader.vs/shader.fs, each one a #define in the compiled variant
+enum ShaderFeature : uint32_t {
+    ShaderFeatureBulbEmissive = 1 << 0, // BULB_EMISSIVE: flat flickering glow, no lighting
+    ShaderFeatureNormalMap = 1 << 1,    // NORMAL_MAP: tangent-space normal map instead of the vertex normal
+};
+
+// Lit variants sum a fixed number of lights (LIGHT_COUNT) so the loop has a constant bound:
+// the frame's light count rounded up to a multiple of LightBucketSize
+constexpr int LightBucketSize = 8;
+int LightCountBucket(int numLights);
+
+// One table of the carousel program variants, compiled from the same two sources with a block
+// of #defines inserted after #version. Meshes pick their features at load time and the renderer
+// asks for (features, light bucket) every frame. Each combination is compiled on first use, the
+// renderer requests the model's combinations once it loads so that happens before drawing.
+// Must only be used on the thread that holds the GL context.
+class ShaderVariants {
+public:
+    // Compiles and links a vertex/fragment pair, e.g. through the ProgramCache
+    typedef std::function<unsigned int(const std::string& vertexSource, const std::string& fragmentSource)> CompileFunction;
+
+    explicit ShaderVariants(CompileFunction compile);
+    ~ShaderVariants();
+    ShaderVariants(const ShaderVariants&) = delete;
+    ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+    void SetSources(std::string vertexSource, std::string fragmentSource);
+    bool HasSources() const { return !vertexSource.empty(); }
+
+    // Emissive variants ignore the normal map and light count, so those collapse into one program
+    unsigned int Get(uint32_t features, int lightCount);
+    size_t GetProgramCount() const { return programs.size(); }
+
+private:
+    static uint32_t normalize(uint32_t features, int& lightCount);
+    static std::string withDefines(const std::string& source, const std::string& defines);
+
+    CompileFunction compile;
+    std::string vertexSource, fragmentSource;
+    std::unordered_map<uint32_t, unsigned int> programs; // features | lightCount << 16
+};
+
+#endif
@@ -0,0 +1,210 @@
+#include "Simulation.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include "Profiler.h"
+
+Simulation::Simulation(JobSystem& jobs)
+    : jobs(jobs) {
+    // The turntable spins about the world up axis, the carousel node scales the model onto it
+    turntableNode = scene.AddNode("turntable", SceneGraph::NoNode, glm::mat4(1.0f));
+    carouselNode = scene.AddNode("carousel", turntableNode, glm::scale(glm::mat4(1.0f), glm::vec3(0.01f)));
+    horseNodes.fill(SceneGraph::NoNode);
+    saddleNodes.fill(SceneGraph::NoNode);
+}
+
+void Simulation::SetModel(const std::vector<SceneNodeData>& nodes, size_t meshCount, const std::vector<glm::vec3>& bulbs) {
+    bulbPositions = bulbs;
+    if (bulbPositions.size() > MaxPointLights) {
+        bulbPositions.resize(MaxPointLights);
+    }
+    lightsChanged = true;
+
+    // The imported hierarchy goes under the carousel node. There is one draw per mesh, a mesh used
+    // by several nodes follows the last one.
+    std::vector<SceneGraph::NodeId> nodeIds(nodes.size());
+    meshNodes.assign(meshCount, carouselNode);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const SceneNodeData& node = nodes[i];
+        nodeIds[i] = scene.AddNode(node.name, node.parent < 0 ? carouselNode : nodeIds[node.parent], node.local);
+        for (unsigned int mesh : node.meshes) {
+            if (mesh < meshNodes.size()) meshNodes[mesh] = nodeIds[i];
+        }
+    }
+
+    // Meshes 0 and 1 are the black and the white horse. The saddles are in model units, Z is up.
+    const glm::vec3 saddles[] = { glm::vec3(14.0f, 182.5f, 150.0f), glm::vec3(14.0f, 120.5f, 150.0f) };
+    for (size_t horse = 0; horse < horseNodes.size() && horse < meshNodes.size(); ++horse) {
+        if (meshNodes[horse] == carouselNode) continue;
+        horseNodes[horse] = meshNodes[horse];
+        horseRestLocals[horse] = scene.GetLocal(horseNodes[horse]);
+        saddleNodes[horse] = scene.AddNode(horse == 0 ? "black horse saddle" : "white horse saddle", horseNodes[horse],
+            glm::translate(glm::mat4(1.0f), saddles[horse]));
+    }
+    posedRotation = posedHorseTime = std::numeric_limits<float>::quiet_NaN();
+}
+
+void Simulation::SkipIdleTicks(uint64_t ticks) {
+    tickCount += ticks;
+    resumedFromIdle = true;
+}
+
+// Input handling for camera free mode
+void Simulation::updateCamera(const InputFrame& input) {
+    // Toggle between free and mounted camera modes
+    bool toggled = input.WasPressed(GLFW_KEY_C);
+    if (toggled) {
+        freeCamera = !freeCamera;
+    }
+
+    // Updates camera orientation based on mouse movement (ignored on the toggle tick, like a reset mouse)
+    if (!toggled) {
+        float sensitivity = 0.1f;
+        yaw += input.mouseDelta.x * sensitivity;
+        pitch += input.mouseDelta.y * sensitivity;
+
+        if (pitch > 89.0f) pitch = 89.0f;
+        if (pitch < -89.0f) pitch = -89.0f;
+
+        glm::vec3 direction;
+        direction.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
+        direction.y = sin(glm::radians(pitch));
+        direction.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
+        cameraFront = glm::normalize(direction);
+    }
+
+    // Carousel control with arrow keys regardless of camera mode
+    if (input.IsDown(GLFW_KEY_RIGHT)) {
+        angularVelocity += angularAcceleration;
+        if (angularVelocity > 1.5f) angularVelocity = 1.5f;
+    }
+    else if (input.IsDown(GLFW_KEY_LEFT)) {
+        angularVelocity -= angularAcceleration;
+        if (angularVelocity < 0.0f) angularVelocity = 0.0f;
+    }
+
+    // Change selected horse index
+    if (input.WasPressed(GLFW_KEY_TAB) && !freeCamera) {
+        selectedHorseIndex = (selectedHorseIndex + 1) % 2;
+    }
+
+    // WASD camera movement in free mode
+    if (freeCamera) {
+        if (input.IsDown(GLFW_KEY_W))
+            cameraPos += cameraSpeed * cameraFront;
+        if (input.IsDown(GLFW_KEY_S))
+            cameraPos -= cameraSpeed * cameraFront;
+        if (input.IsDown(GLFW_KEY_A))
+            cameraPos -= glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+        if (input.IsDown(GLFW_KEY_D))
+            cameraPos += glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
+
+        glm::vec3 carouselCenter = glm::vec3(0.0f, 0.0f, 0.0f); // Center in world space
+        float carouselRadius = 3.0f;  // Match your carousel's real radius
+        float carouselHeight = 4.0f;  // Optional vertical cap
+
+        glm::vec2 camXZ = glm::vec2(cameraPos.x, cameraPos.z);
+        glm::vec2 centerXZ = glm::vec2(carouselCenter.x, carouselCenter.z);
+        float dist = glm::length(camXZ - centerXZ);
+
+        if (dist < carouselRadius) {
+            glm::vec2 pushDir = glm::normalize(camXZ - centerXZ);
+            glm::vec2 safePosXZ = centerXZ + pushDir * carouselRadius;
+            cameraPos.x = safePosXZ.x;
+            cameraPos.z = safePosXZ.y;
+        }
+
+        // Y-axis camera clamp
+        if (cameraPos.y < 0.2f) cameraPos.y = 0.2f;
+        if (cameraPos.y > carouselHeight) cameraPos.y = carouselHeight;
+    }
+}
+
+// Sets the local transforms that changed since the last tick, the graph recomputes their subtrees
+void Simulation::animateCarousel() {
+    if (rotation != posedRotation) {
+        scene.SetLocal(turntableNode, glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0, 1, 0)));
+        posedRotation = rotation;
+    }
+    if (horseAnimationTime != posedHorseTime) {
+        for (size_t horse = 0; horse < horseNodes.size(); ++horse) {
+            if (horseNodes[horse] == SceneGraph::NoNode) continue;
+            // Z acts as Y in the model, pi does the movement intercalation between the two horses
+            float verticalOffset = sin(horseAnimationTime + horse * glm::pi<float>()) * 2.8f;
+            scene.SetLocal(horseNodes[horse], glm::translate(horseRestLocals[horse], glm::vec3(0.0f, 0.0f, verticalOffset)));
+        }
+        posedHorseTime = horseAnimationTime;
+    }
+    scene.Update(jobs);
+}
+
+glm::mat4 Simulation::computeView() const {
+    // Until the model is in there is no horse to sit on
+    SceneGraph::NodeId saddle = saddleNodes[selectedHorseIndex];
+    if (freeCamera || saddle == SceneGraph::NoNode) {
+        return glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+    }
+
+    // The saddle node rides the spin and the bobbing of its horse
+    glm::vec3 horseWorldPos = glm::vec3(scene.GetWorld(saddle)[3]);
+
+    float correctedYaw = yaw - rotation; // subtract carousel spin
+
+    // Camera always looks in direction of yaw/pitch, from the horse's world position
+    glm::vec3 lookDir;
+    lookDir.x = cos(glm::radians(correctedYaw)) * cos(glm::radians(pitch));
+    lookDir.y = sin(glm::radians(pitch));
+    lookDir.z = sin(glm::radians(correctedYaw)) * cos(glm::radians(pitch));
+
+    // Final view of the mounted camera
+    return glm::lookAt(horseWorldPos, horseWorldPos + glm::normalize(lookDir), glm::vec3(0, 1, 0));
+}
+
+void Simulation::Tick(const InputFrame& input, FrameSnapshot& out) {
+    PROFILE_SCOPE("Simulation tick");
+    float previousRotation = rotation, previousHorseTime = horseAnimationTime;
+    updateCamera(input);
+    bool toggledHud = input.WasPressed(GLFW_KEY_F3);
+    if (toggledHud) {
+        showHud = !showHud;
+    }
+
+    rotation += angularVelocity * 0.5f;
+    if (rotation > 360.0f) rotation -= 360.0f;
+    if (!horsesRestWhenStopped || angularVelocity > 0.0f) {
+        horseAnimationTime += 0.02f;
+    }
+    animateCarousel();
+
+    // Warm carousel bulb lights ride the turntable
+    const glm::mat4& lightSpin = scene.GetWorld(turntableNode);
+    out.numLights = static_cast<int>(bulbPositions.size());
+    // One mat4 * vec4 per bulb is a few nanoseconds; a job only pays off for thousands of them,
+    // so the carousel's few dozen run inline
+    jobs.ParallelFor(bulbPositions.size(), 4096, [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("Light transforms");
+        for (size_t i = begin; i < end; ++i) {
+            out.lightPositions[i] = glm::vec3(lightSpin * glm::vec4(bulbPositions[i], 1.0f));
+        }
+        });
+
+    ++tickCount;
+    out.tick = tickCount;
+    out.time = static_cast<float>(tickCount * TickSeconds);
+    out.cameraPos = cameraPos;
+    out.view = computeView();
+    out.rotation = rotation;
+    out.meshTransforms.resize(meshNodes.size());
+    for (size_t i = 0; i < meshNodes.size(); ++i) {
+        out.meshTransforms[i] = scene.GetWorld(meshNodes[i]);
+    }
+    out.showHud = showHud;
+
+    out.changes = 0;
+    if (out.view != lastView) out.changes |= SceneChangeCamera;
+    if (rotation != previousRotation || horseAnimationTime != previousHorseTime) out.changes |= SceneChangeCarousel;
+    if (toggledHud) out.changes |= SceneChangeOverlay;
+    if (lightsChanged) out.changes |= SceneChangeLights;
+    out.resumedFromIdle = resumedFromIdle;
+    lastView = out.view;
+    lightsChanged = false;
+    resumedFromIdle = false;
+}
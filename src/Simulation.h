@@ -0,0 +1,75 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <array>
+#include <glm/glm.hpp>
+#include <limits>
+#include <vector>
+#include "FrameSnapshot.h"
+#include "Input.h"
+#include "JobSystem.h"
+#include "SceneGraph.h"
+
+// Camera, carousel physics and light transforms. Runs on its own thread at a fixed tick rate
+// and writes the result of every tick into a FrameSnapshot for the render thread.
+//
+// The carousel is a SceneGraph: a turntable node spins, the model's nodes hang below it and the
+// horses bob on their mesh nodes. The bulbs and the mounted camera are attached to nodes, so a
+// tick only sets local transforms and the graph recomputes what moved.
+class Simulation {
+public:
+    static constexpr double TickSeconds = 1.0 / 60.0;
+
+    explicit Simulation(JobSystem& jobs);
+    void Tick(const InputFrame& input, FrameSnapshot& out);
+    // The node hierarchy and the bulbs arrive with the model (ModelData), which loads in the background
+    void SetModel(const std::vector<SceneNodeData>& nodes, size_t meshCount, const std::vector<glm::vec3>& bulbs);
+    // The horses only bob while the carousel turns, so a stopped carousel and a still camera
+    // leave nothing to animate (render-on-demand mode)
+    void SetHorsesRestWhenStopped(bool rest) { horsesRestWhenStopped = rest; }
+    // Moves the clock past ticks skipped while idle, nothing else changes during them
+    void SkipIdleTicks(uint64_t ticks);
+
+private:
+    void updateCamera(const InputFrame& input);
+    void animateCarousel();
+    glm::mat4 computeView() const;
+
+    JobSystem& jobs;
+    SceneGraph scene;
+    SceneGraph::NodeId turntableNode, carouselNode;
+    std::vector<SceneGraph::NodeId> meshNodes;      // world matrix of each model mesh
+    std::array<SceneGraph::NodeId, 2> horseNodes;   // bobbing mesh nodes, NoNode until the model is in
+    std::array<glm::mat4, 2> horseRestLocals;
+    std::array<SceneGraph::NodeId, 2> saddleNodes;  // mounted camera positions on the horses
+    std::vector<glm::vec3> bulbPositions;           // relative to the turntable
+    uint64_t tickCount = 0;
+    bool resumedFromIdle = false;
+
+    // Camera
+    float yaw = -90.0f, pitch = 0.0f;
+    glm::vec3 cameraPos = glm::vec3(0.0f, 2.0f, 8.0f);
+    glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
+    bool freeCamera = true;
+    int selectedHorseIndex = 0;
+    float cameraSpeed = 0.05f;
+
+    // Carousel
+    float rotation = 0.0f;
+    float angularVelocity = 0.0f;
+    float angularAcceleration = 0.005f;
+    float horseAnimationTime = 0.0f;
+    bool horsesRestWhenStopped = false;
+    // What the scene graph shows, NaN forces a new pose
+    float posedRotation = std::numeric_limits<float>::quiet_NaN();
+    float posedHorseTime = std::numeric_limits<float>::quiet_NaN();
+
+    bool showHud = false;
+
+    // Compared with each tick's result to fill FrameSnapshot::changes
+    glm::mat4 lastView = glm::mat4(0.0f);
+    bool lightsChanged = true;
+};
+
+#endif
@@ -0,0 +1,113 @@
+#include "StreamBuffer.h"
+#include <algorithm>
+#include <iostream>
+#include "GLExtensions.h"
+#include "Profiler.h"
+
+namespace {
+// ARB_buffer_storage, not in glad's GL 3.3 core
+constexpr GLbitfield GL_MAP_PERSISTENT_BIT = 0x0040;
+constexpr GLbitfield GL_MAP_COHERENT_BIT = 0x0080;
+typedef void (APIENTRYP BufferStorageProc)(GLenum, GLsizeiptr, const void*, GLbitfield);
+}
+
+StreamBuffer::StreamBuffer(GLenum target, size_t frameSize, const std::string& owner)
+    : target(target), frameSize(frameSize) {
+    GLint alignment = 1;
+    if (target == GL_UNIFORM_BUFFER) {
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    }
+    defaultAlignment = static_cast<size_t>(std::max(alignment, 1));
+    // Every region starts aligned, whatever the caller's alignment
+    this->frameSize = (frameSize + 255) & ~size_t(255);
+
+    BufferStorageProc bufferStorage = nullptr;
+    if (GetGLVersion() >= 44 || HasGLExtension("GL_ARB_buffer_storage")) {
+        bufferStorage = reinterpret_cast<BufferStorageProc>(GetGLProcAddress("glBufferStorage"));
+    }
+
+    GLsizeiptr totalSize = static_cast<GLsizeiptr>(this->frameSize * FrameCount);
+    glGenBuffers(1, &buffer);
+    glBindBuffer(target, buffer);
+    if (bufferStorage) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(target, totalSize, nullptr, flags);
+        persistent = static_cast<unsigned char*>(glMapBufferRange(target, 0, totalSize, flags));
+    }
+    if (!persistent) {
+        glBufferData(target, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(target, 0);
+    memory = TrackedMemory(MemoryCategory::Staging, owner, "stream buffer, " + std::to_string(FrameCount) + " regions", "bytes",
+        static_cast<size_t>(totalSize));
+    std::cout << "[StreamBuffer] " << FrameCount << " x " << this->frameSize / 1024 << " KB, "
+        << (persistent ? "persistent coherent mapping" : "unsynchronized mapping per frame") << std::endl;
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync& fence : fences) {
+        if (fence) glDeleteSync(fence);
+    }
+    if (persistent || mapped) {
+        glBindBuffer(target, buffer);
+        glUnmapBuffer(target);
+        glBindBuffer(target, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+void StreamBuffer::BeginFrame() {
+    region = (region + 1) % FrameCount;
+    used = 0;
+
+    GLsync& fence = fences[region];
+    if (!fence) return;
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+        // The GPU is FrameCount frames behind, better to wait than to overwrite what it reads
+        PROFILE_SCOPE("Stream buffer stall");
+        ++stalls;
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1'000'000'000ull);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+StreamBuffer::Allocation StreamBuffer::Allocate(size_t size, size_t alignment) {
+    if (alignment == 0) alignment = defaultAlignment;
+    size_t offset = (used + alignment - 1) / alignment * alignment;
+    if (offset + size > frameSize) {
+        std::cerr << "[StreamBuffer] Frame region of " << frameSize << " bytes is full" << std::endl;
+        return Allocation();
+    }
+
+    if (!persistent && !mapped) {
+        // The fence in BeginFrame() already guarantees the GPU is done with this region
+        glBindBuffer(target, buffer);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(target, region * frameSize, frameSize,
+            GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT));
+        glBindBuffer(target, 0);
+        if (!mapped) return Allocation();
+    }
+    unsigned char* base = persistent ? persistent + region * frameSize : mapped;
+
+    used = offset + size;
+    Allocation allocation;
+    allocation.data = base + offset;
+    allocation.offset = static_cast<GLintptr>(region * frameSize + offset);
+    allocation.size = static_cast<GLsizeiptr>(size);
+    return allocation;
+}
+
+void StreamBuffer::Flush() {
+    if (!mapped) return; // coherent mappings need no flush
+    glBindBuffer(target, buffer);
+    glFlushMappedBufferRange(target, 0, static_cast<GLsizeiptr>(used));
+    glUnmapBuffer(target);
+    glBindBuffer(target, 0);
+    mapped = nullptr;
+}
+
+void StreamBuffer::EndFrame() {
+    Flush();
+    fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
@@ -0,0 +1,66 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <glad/glad.h>
+#include "MemoryTracker.h"
+
+// Ring buffer for data rewritten every frame (uniform blocks, instance attributes). The buffer is
+// split into FrameCount regions and each frame suballocates from the next one, so the CPU writes
+// while the GPU still reads the regions of the previous frames. A fence per region guards reuse;
+// with three regions it has normally signaled long before, so nothing stalls and the storage is
+// never reallocated.
+//
+// With GL 4.4 or ARB_buffer_storage the buffer is mapped once, persistent and coherent. On plain
+// GL 3.3 the frame's region is mapped unsynchronized on the first Allocate() and unmapped by
+// Flush(), the fences take the place of the driver's implicit synchronization.
+// Must only be used on the thread that holds the GL context.
+class StreamBuffer {
+public:
+    static constexpr int FrameCount = 3;
+
+    struct Allocation {
+        unsigned char* data = nullptr; // write-only, nullptr when the region is full
+        GLintptr offset = 0;           // from the start of GetBuffer()
+        GLsizeiptr size = 0;
+    };
+
+    // target only picks the default alignment (e.g. GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT); owner is
+    // what the MemoryTracker lists the buffer under
+    StreamBuffer(GLenum target, size_t frameSize, const std::string& owner);
+    ~StreamBuffer();
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    // Moves to the next region, waiting for the GPU to finish the frame that last used it
+    void BeginFrame();
+    // size bytes in this frame's region; alignment 0 uses the target's offset alignment
+    Allocation Allocate(size_t size, size_t alignment = 0);
+    // Makes this frame's writes visible to the GPU, call before the draws that read them
+    void Flush();
+    // Call after the last draw that reads this frame's allocations
+    void EndFrame();
+
+    unsigned int GetBuffer() const { return buffer; }
+    bool IsPersistent() const { return persistent != nullptr; }
+    // BeginFrame() calls that had to wait for the GPU
+    int GetStallCount() const { return stalls; }
+    size_t GetFrameSize() const { return frameSize; }
+
+private:
+    GLenum target;
+    size_t frameSize;
+    size_t defaultAlignment = 1;
+    unsigned int buffer = 0;
+    unsigned char* persistent = nullptr; // whole buffer, persistent mapping only
+    unsigned char* mapped = nullptr;     // this frame's region
+    std::array<GLsync, FrameCount> fences = {};
+    int region = FrameCount - 1;
+    size_t used = 0;
+    int stalls = 0;
+    TrackedMemory memory;
+};
+
+#endif
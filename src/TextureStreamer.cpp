@@ -0,0 +1,150 @@
+#include "TextureStreamer.h"
+#include <algorithm>
+#include <cstring>
+#include "CompressedTexture.h"
+#include "Profiler.h"
+
+TextureStreamer::TextureStreamer(size_t frameBudgetBytes, int stagingBufferCount)
+    : frameBudget(std::max<size_t>(frameBudgetBytes, 256 * 1024)) { // at least one row of any sane texture
+    staging.resize(std::max(stagingBufferCount, 1));
+    for (size_t i = 0; i < staging.size(); ++i) {
+        glGenBuffers(1, &staging[i].pbo);
+        // Sized by the first Update() that uses it
+        staging[i].memory = TrackedMemory(MemoryCategory::Staging, "texture streamer", "upload buffer " + std::to_string(i), "bytes", 0);
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    for (StagingBuffer& buffer : staging) {
+        if (buffer.fence) glDeleteSync(buffer.fence);
+        glDeleteBuffers(1, &buffer.pbo);
+    }
+}
+
+unsigned int TextureStreamer::Enqueue(std::shared_ptr<const ImageData> image, GLint wrapMode, bool mipmapped,
+    const std::string& owner, const std::string& name) {
+    if (!image || !image->Valid()) {
+        return 0;
+    }
+
+    bool compressed = image->compressedFormat != 0;
+    GLenum format = compressed ? image->compressedFormat
+        : image->channels == 1 ? GL_RED : image->channels == 3 ? GL_RGB : GL_RGBA;
+    int levels = mipmapped ? image->LevelCount() : 1;
+
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+
+    // Storage for every level now, pixels later
+    size_t textureBytes = 0;
+    for (int level = 0; level < levels; ++level) {
+        int width = image->LevelWidth(level), height = image->LevelHeight(level);
+        textureBytes += MemoryTracker::TextureLevelBytes(format, width, height);
+        if (compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0,
+                static_cast<GLsizei>(CompressedLevelSize(format, width, height)), nullptr);
+        }
+        else {
+            glTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+        }
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Sample only the levels that have arrived, starting with the smallest
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, levels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+
+    textureMemory.emplace_back(MemoryCategory::Textures, owner, name + ", " + std::to_string(image->width) + "x"
+        + std::to_string(image->height) + ", " + std::to_string(levels) + " levels", MemoryTracker::FormatName(format), textureBytes);
+    uploads.push_back(Upload{ textureID, std::move(image), format, compressed, levels - 1, 0 });
+    return textureID;
+}
+
+void TextureStreamer::Update() {
+    PROFILE_SCOPE("Texture streaming");
+    lastFrameBytes = 0;
+    if (uploads.empty()) return;
+
+    // The driver may still be reading this PBO from a few frames ago, try again next frame
+    StagingBuffer& buffer = staging[nextStaging];
+    if (buffer.fence) {
+        if (glClientWaitSync(buffer.fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return;
+        }
+        glDeleteSync(buffer.fence);
+        buffer.fence = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, frameBudget, nullptr, GL_STREAM_DRAW); // orphan the old storage
+    buffer.memory.Resize(frameBudget);
+    unsigned char* mapped = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, frameBudget,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    if (!mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return;
+    }
+
+    // Stage whole levels, or bands of rows when a level is larger than what is left of the budget.
+    // Compressed levels are cut between rows of 4x4 blocks.
+    copies.clear();
+    size_t offset = 0;
+    while (!uploads.empty()) {
+        Upload& upload = uploads.front();
+        const ImageData& image = *upload.image;
+        int width = image.LevelWidth(upload.level);
+        int height = image.LevelHeight(upload.level);
+        int rowHeight = upload.compressed ? 4 : 1;
+        int rowCount = (height + rowHeight - 1) / rowHeight;
+        size_t rowBytes = upload.compressed ? CompressedLevelSize(upload.format, width, 1) : static_cast<size_t>(width) * image.channels;
+
+        size_t rowsThatFit = (frameBudget - offset) / rowBytes;
+        int rows = static_cast<int>(std::min<size_t>(rowsThatFit, static_cast<size_t>(rowCount - upload.row)));
+        if (rows == 0) break;
+
+        std::memcpy(mapped + offset, image.LevelPixels(upload.level) + upload.row * rowBytes, rows * rowBytes);
+
+        int y = upload.row * rowHeight;
+        upload.row += rows;
+        bool levelComplete = upload.row == rowCount;
+        copies.push_back(Copy{ upload.texture, upload.format, upload.compressed, upload.level, y, width,
+            std::min(rows * rowHeight, height - y), offset, rows * rowBytes, levelComplete });
+
+        offset += (rows * rowBytes + 15) & ~size_t(15); // keep every copy 16-byte aligned
+        if (levelComplete) {
+            upload.row = 0;
+            if (--upload.level < 0) {
+                uploads.pop_front();
+            }
+        }
+        if (offset >= frameBudget) break;
+    }
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    glActiveTexture(GL_TEXTURE0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (const Copy& copy : copies) {
+        glBindTexture(GL_TEXTURE_2D, copy.texture);
+        if (copy.compressed) {
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, copy.level, 0, copy.y, copy.width, copy.height, copy.format,
+                static_cast<GLsizei>(copy.bytes), reinterpret_cast<const void*>(copy.offset));
+        }
+        else {
+            glTexSubImage2D(GL_TEXTURE_2D, copy.level, 0, copy.y, copy.width, copy.height, copy.format, GL_UNSIGNED_BYTE,
+                reinterpret_cast<const void*>(copy.offset));
+        }
+        if (copy.levelComplete) {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, copy.level);
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    nextStaging = (nextStaging + 1) % staging.size();
+    lastFrameBytes = offset;
+}
@@ -0,0 +1,75 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <glad/glad.h>
+#include "AssetManager.h"
+#include "MemoryTracker.h"
+
+// Time-sliced texture uploads through a ring of pixel buffer objects. Enqueue() hands back a
+// texture name right away; Update() then copies at most frameBudget bytes per frame into an
+// orphaned PBO and issues one glTexSubImage2D per mip level (or band of rows for large levels).
+// Levels go smallest first and GL_TEXTURE_BASE_LEVEL follows them, so textures sharpen in place.
+// A fence per PBO tells when the driver is done reading it and the staging memory can be reused.
+// Baked block-compressed images go through the same path with glCompressedTexSubImage2D.
+class TextureStreamer {
+public:
+    explicit TextureStreamer(size_t frameBudgetBytes = 4 * 1024 * 1024, int stagingBufferCount = 3);
+    ~TextureStreamer();
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Allocates the texture storage and queues its pixels. Mipmapped textures need image.mips.
+    // Compressed images need a format the driver supports (see HasGLExtension). The storage is
+    // registered with the MemoryTracker under owner and name.
+    unsigned int Enqueue(std::shared_ptr<const ImageData> image, GLint wrapMode, bool mipmapped,
+        const std::string& owner, const std::string& name);
+
+    // Streams this frame's share of the queue, call once per frame on the GL thread
+    void Update();
+
+    bool IsIdle() const { return uploads.empty(); }
+    size_t GetPendingCount() const { return uploads.size(); }
+    size_t GetLastFrameBytes() const { return lastFrameBytes; }
+
+private:
+    struct Upload {
+        unsigned int texture;
+        std::shared_ptr<const ImageData> image;
+        GLenum format;
+        bool compressed;
+        int level;  // level being streamed, counts down to 0
+        int row;    // first row (of pixels, or of 4x4 blocks if compressed) not yet staged
+    };
+
+    struct StagingBuffer {
+        unsigned int pbo = 0;
+        GLsync fence = nullptr;
+        TrackedMemory memory;
+    };
+
+    // One glTexSubImage2D recorded while the PBO is mapped
+    struct Copy {
+        unsigned int texture;
+        GLenum format;
+        bool compressed;
+        int level, y, width, height; // in pixels
+        size_t offset, bytes;
+        bool levelComplete;
+    };
+
+    std::deque<Upload> uploads;
+    std::vector<StagingBuffer> staging;
+    std::vector<Copy> copies;
+    // Of every texture created here; nothing deletes them while the streamer lives
+    std::vector<TrackedMemory> textureMemory;
+    size_t nextStaging = 0;
+    size_t frameBudget;
+    size_t lastFrameBytes = 0;
+};
+
+#endif
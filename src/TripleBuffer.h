@@ -0,0 +1,68 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Single-producer / single-consumer mailbox. The producer always owns one slot to write into,
+// the consumer always owns one slot to read from, and the third slot is swapped between them,
+// so the simulation never waits on the renderer and the renderer always sees the newest frame.
+template <typename T>
+class TripleBuffer {
+public:
+    // Slot the producer fills before calling Publish()
+    T& WriteBuffer() { return slots[writeIndex]; }
+
+    // Hands the written slot to the consumer and takes back whichever slot was shared
+    void Publish() {
+        int previous = shared.exchange(writeIndex | freshBit, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+        {
+            std::lock_guard<std::mutex> lock(waitMutex);
+        }
+        published.notify_one();
+    }
+
+    // Swaps in the newest published slot, returns false if nothing new arrived since the last fetch
+    bool Fetch() {
+        if (!(shared.load(std::memory_order_acquire) & freshBit)) {
+            return false;
+        }
+        int previous = shared.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    // Like Fetch(), but sleeps until the producer publishes or the timeout expires
+    bool WaitAndFetch(std::chrono::milliseconds timeout) {
+        if (Fetch()) {
+            return true;
+        }
+        {
+            std::unique_lock<std::mutex> lock(waitMutex);
+            published.wait_for(lock, timeout, [this] {
+                return (shared.load(std::memory_order_acquire) & freshBit) != 0;
+            });
+        }
+        return Fetch();
+    }
+
+    // Slot the consumer reads after a successful Fetch()
+    const T& ReadBuffer() const { return slots[readIndex]; }
+
+private:
+    static constexpr int indexMask = 0x3;
+    static constexpr int freshBit = 0x4;
+
+    T slots[3];
+    int writeIndex = 0;             // producer-owned
+    int readIndex = 1;              // consumer-owned
+    std::atomic<int> shared{ 2 };   // index of the exchanged slot plus the fresh bit
+
+    std::mutex waitMutex;
+    std::condition_variable published;
+};
+
+#endif
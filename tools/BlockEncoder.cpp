@@ -0,0 +1,155 @@
+#include "BlockEncoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace {
+
+// Gathers the 16 texels of block (bx, by), clamping at the image edge
+void fetchBlock(const unsigned char* pixels, int width, int height, int channels, int bx, int by, glm::vec3 block[16]) {
+    for (int y = 0; y < 4; ++y) {
+        int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; ++x) {
+            int sx = std::min(bx * 4 + x, width - 1);
+            const unsigned char* p = pixels + (static_cast<size_t>(sy) * width + sx) * channels;
+            block[y * 4 + x] = glm::vec3(p[0], channels > 1 ? p[1] : p[0], channels > 2 ? p[2] : p[0]);
+        }
+    }
+}
+
+uint16_t packRGB565(const glm::vec3& color) {
+    int r = static_cast<int>(std::lround(glm::clamp(color.r, 0.0f, 255.0f) * 31.0f / 255.0f));
+    int g = static_cast<int>(std::lround(glm::clamp(color.g, 0.0f, 255.0f) * 63.0f / 255.0f));
+    int b = static_cast<int>(std::lround(glm::clamp(color.b, 0.0f, 255.0f) * 31.0f / 255.0f));
+    return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+glm::vec3 unpackRGB565(uint16_t packed) {
+    int r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    return glm::vec3((r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2));
+}
+
+void encodeBC1Block(const glm::vec3 block[16], unsigned char* out) {
+    // Endpoints on the principal axis of the block's colors (a few power iterations are enough)
+    glm::vec3 mean(0.0f);
+    for (int i = 0; i < 16; ++i) mean += block[i];
+    mean /= 16.0f;
+
+    float cov[6] = { 0, 0, 0, 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        glm::vec3 d = block[i] - mean;
+        cov[0] += d.r * d.r; cov[1] += d.r * d.g; cov[2] += d.r * d.b;
+        cov[3] += d.g * d.g; cov[4] += d.g * d.b; cov[5] += d.b * d.b;
+    }
+    glm::vec3 axis(1.0f, 1.0f, 1.0f);
+    for (int iteration = 0; iteration < 4; ++iteration) {
+        glm::vec3 next(cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+                       cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+                       cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b);
+        float length = glm::length(next);
+        if (length < 1e-6f) break;
+        axis = next / length;
+    }
+
+    float minProj = 1e9f, maxProj = -1e9f;
+    for (int i = 0; i < 16; ++i) {
+        float t = glm::dot(block[i] - mean, axis);
+        minProj = std::min(minProj, t);
+        maxProj = std::max(maxProj, t);
+    }
+    // Inset the endpoints a little, the extremes are usually noise
+    float inset = (maxProj - minProj) / 16.0f;
+    uint16_t color0 = packRGB565(mean + axis * (maxProj - inset));
+    uint16_t color1 = packRGB565(mean + axis * (minProj + inset));
+    if (color0 < color1) std::swap(color0, color1); // color0 > color1 selects the opaque 4-color mode
+
+    glm::vec3 palette[4];
+    palette[0] = unpackRGB565(color0);
+    palette[1] = unpackRGB565(color1);
+    palette[2] = (palette[0] * 2.0f + palette[1]) / 3.0f;
+    palette[3] = (palette[0] + palette[1] * 2.0f) / 3.0f;
+
+    uint32_t indices = 0;
+    if (color0 != color1) {
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            float bestError = 1e30f;
+            for (int p = 0; p < 4; ++p) {
+                glm::vec3 d = block[i] - palette[p];
+                float error = glm::dot(d, d);
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= static_cast<uint32_t>(best) << (i * 2);
+        }
+    }
+
+    out[0] = color0 & 0xFF; out[1] = color0 >> 8;
+    out[2] = color1 & 0xFF; out[3] = color1 >> 8;
+    for (int i = 0; i < 4; ++i) out[4 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+// One channel (0..255 per texel) into an 8-value BC4 block
+void encodeBC4Block(const float values[16], unsigned char* out) {
+    float lo = 255.0f, hi = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        lo = std::min(lo, values[i]);
+        hi = std::max(hi, values[i]);
+    }
+    int red0 = static_cast<int>(std::lround(hi)), red1 = static_cast<int>(std::lround(lo));
+
+    uint64_t indices = 0;
+    if (red0 != red1) {
+        // red0 > red1: index 0 = red0, 1 = red1, 2..7 = six interpolated steps from red0 to red1
+        float palette[8] = { float(red0), float(red1) };
+        for (int p = 1; p <= 6; ++p) palette[p + 1] = ((7 - p) * red0 + p * red1) / 7.0f;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0;
+            float bestError = 1e30f;
+            for (int p = 0; p < 8; ++p) {
+                float error = std::abs(values[i] - palette[p]);
+                if (error < bestError) { bestError = error; best = p; }
+            }
+            indices |= static_cast<uint64_t>(best) << (i * 3);
+        }
+    }
+
+    out[0] = static_cast<unsigned char>(red0);
+    out[1] = static_cast<unsigned char>(red1);
+    for (int i = 0; i < 6; ++i) out[2 + i] = (indices >> (i * 8)) & 0xFF;
+}
+
+}
+
+std::vector<unsigned char> EncodeBC1(const unsigned char* pixels, int width, int height, int channels) {
+    int blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+    std::vector<unsigned char> blocks(static_cast<size_t>(blocksWide) * blocksHigh * 8);
+    glm::vec3 block[16];
+    for (int by = 0; by < blocksHigh; ++by) {
+        for (int bx = 0; bx < blocksWide; ++bx) {
+            fetchBlock(pixels, width, height, channels, bx, by, block);
+            encodeBC1Block(block, &blocks[(static_cast<size_t>(by) * blocksWide + bx) * 8]);
+        }
+    }
+    return blocks;
+}
+
+std::vector<unsigned char> EncodeBC5(const unsigned char* pixels, int width, int height, int channels) {
+    int blocksWide = (width + 3) / 4, blocksHigh = (height + 3) / 4;
+    std::vector<unsigned char> blocks(static_cast<size_t>(blocksWide) * blocksHigh * 16);
+    glm::vec3 block[16];
+    float red[16], green[16];
+    for (int by = 0; by < blocksHigh; ++by) {
+        for (int bx = 0; bx < blocksWide; ++bx) {
+            fetchBlock(pixels, width, height, channels, bx, by, block);
+            for (int i = 0; i < 16; ++i) {
+                red[i] = block[i].r;
+                green[i] = block[i].g;
+            }
+            unsigned char* out = &blocks[(static_cast<size_t>(by) * blocksWide + bx) * 16];
+            encodeBC4Block(red, out);
+            encodeBC4Block(green, out + 8);
+        }
+    }
+    return blocks;
+}
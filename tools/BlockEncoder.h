@@ -0,0 +1,16 @@
+#ifndef BLOCK_ENCODER_H
+#define BLOCK_ENCODER_H
+
+#include <vector>
+
+// CPU block compressors used by carousel_bake. Both take one mip level of tightly packed 8-bit
+// pixels and return its 4x4 blocks in row-major block order, ready for glCompressedTexImage2D.
+// Partial blocks at the right/bottom edge repeat the last row/column.
+
+// BC1 (DXT1), opaque 4-color mode. Reads the first three channels.
+std::vector<unsigned char> EncodeBC1(const unsigned char* pixels, int width, int height, int channels);
+
+// BC5 (RGTC2), two independent BC4 blocks for the first two channels
+std::vector<unsigned char> EncodeBC5(const unsigned char* pixels, int width, int height, int channels);
+
+#endif
@@ -0,0 +1,112 @@
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "AssetManager.h"
+#include "BlockEncoder.h"
+#include "CompressedTexture.h"
+
+// carousel_bake <textures dir>
+// Writes a .ctex next to every opaque JPEG/PNG in the directory: BC5 for normal maps (file name
+// contains "normal"), BC1 for everything else. The full mip chain is baked so the viewer uploads
+// blocks straight from disk. Images with an alpha channel are skipped, BC1 cannot keep it.
+
+namespace {
+
+// Box-filtered normals get shorter towards the small mips, put them back on the unit sphere
+void renormalizeMips(ImageData& image) {
+    for (std::vector<unsigned char>& level : image.mips) {
+        for (size_t i = 0; i + 2 < level.size(); i += 3) {
+            float x = level[i] / 127.5f - 1.0f, y = level[i + 1] / 127.5f - 1.0f, z = level[i + 2] / 127.5f - 1.0f;
+            float length = std::sqrt(x * x + y * y + z * z);
+            if (length < 1e-4f) continue;
+            level[i] = static_cast<unsigned char>(std::lround((x / length + 1.0f) * 127.5f));
+            level[i + 1] = static_cast<unsigned char>(std::lround((y / length + 1.0f) * 127.5f));
+            level[i + 2] = static_cast<unsigned char>(std::lround((z / length + 1.0f) * 127.5f));
+        }
+    }
+}
+
+bool bake(const std::filesystem::path& source) {
+    int width, height, components;
+    if (!stbi_info(source.string().c_str(), &width, &height, &components)) {
+        return false;
+    }
+    if (components == 2 || components == 4) {
+        std::cout << "  skipped " << source.filename().string() << " (has alpha)" << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const ImageData> decoded = AssetManager::DecodeImage(source, 3, true);
+    if (!decoded->Valid()) {
+        return false;
+    }
+    ImageData image = *decoded;
+
+    bool normalMap = source.filename().string().find("normal") != std::string::npos;
+    if (normalMap) {
+        renormalizeMips(image);
+    }
+
+    ImageData baked;
+    baked.width = image.width;
+    baked.height = image.height;
+    baked.compressedFormat = normalMap ? CompressedFormatBC5 : CompressedFormatBC1;
+    size_t rawBytes = 0;
+    for (int level = 0; level < image.LevelCount(); ++level) {
+        int levelWidth = image.LevelWidth(level), levelHeight = image.LevelHeight(level);
+        std::vector<unsigned char> blocks = normalMap
+            ? EncodeBC5(image.LevelPixels(level), levelWidth, levelHeight, 3)
+            : EncodeBC1(image.LevelPixels(level), levelWidth, levelHeight, 3);
+        if (level == 0) baked.pixels = std::move(blocks);
+        else baked.mips.push_back(std::move(blocks));
+        rawBytes += static_cast<size_t>(levelWidth) * levelHeight * 4; // drivers pad RGB8 to RGBA8
+    }
+
+    std::filesystem::path target = BakedTexturePath(source);
+    if (!WriteCompressedTexture(target, baked)) {
+        return false;
+    }
+
+    size_t bakedBytes = 0;
+    for (int level = 0; level < baked.LevelCount(); ++level) {
+        bakedBytes += CompressedLevelSize(baked.compressedFormat, baked.LevelWidth(level), baked.LevelHeight(level));
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  " << source.filename().string() << " -> " << target.filename().string()
+        << (normalMap ? " BC5 " : " BC1 ") << width << "x" << height << ", " << baked.LevelCount() << " levels, "
+        << rawBytes / 1024 << " KB -> " << bakedBytes / 1024 << " KB in " << static_cast<int>(ms) << " ms" << std::endl;
+    return true;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2 || !std::filesystem::is_directory(argv[1])) {
+        std::cerr << "Usage: carousel_bake <textures dir>" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::filesystem::path> sources;
+    for (const auto& entry : std::filesystem::directory_iterator(argv[1])) {
+        std::string extension = entry.path().extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+        if (entry.is_regular_file() && (extension == ".jpg" || extension == ".jpeg" || extension == ".png")) {
+            sources.push_back(entry.path());
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+
+    std::cout << "Baking " << sources.size() << " textures in " << argv[1] << std::endl;
+    int baked = 0;
+    for (const auto& source : sources) {
+        if (bake(source)) ++baked;
+    }
+    std::cout << "Baked " << baked << " of " << sources.size() << std::endl;
+    return 0;
+}